@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Replaces the global operator new/delete for the executable it is linked into and counts every
+ * heap allocation made through them, on any thread.
+ */
+
+namespace allocationCounter {
+
+uint64_t getAllocationCount();
+
+} // namespace allocationCounter
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../examples/2d.hpp"
+#include "../examples/cubes.hpp"
+#include "../examples/renderTexture.hpp"
+#include "../examples/update.hpp"
+#include "allocationCounter.hpp"
+
+/*
+ * vkFrameBench:
+ * Runs each example scene headless for a number of warm-up frames followed by a number of
+ * measured frames, then reports CPU frame time, GPU time and heap allocations per frame as JSON.
+ * It fails if any measured frame allocated on the heap, --max-allocations raises the limit.
+ */
+
+const uint32_t maxFramesInFlight = 2;
+
+struct BenchOptions {
+    uint32_t warmupFrames = 60;
+    uint32_t measuredFrames = 600;
+    uint32_t width = 640;
+    uint32_t height = 480;
+    std::string scene = "all";
+    uint32_t spriteCount = 2;
+    int32_t mapSize = 4;
+    // Zero keeps the instance count each scene uses by default.
+    uint32_t instanceCount = 0;
+    std::string outputPath;
+    // Negative disables the check, 0 requires steady state frames not to allocate at all.
+    int64_t maxAllocations = 0;
+};
+
+struct FrameSample {
+    double cpuMilliseconds = 0.0;
+    double gpuMilliseconds = 0.0;
+    bool gpuValid = false;
+    uint64_t allocations = 0;
+};
+
+struct SceneResult {
+    std::string name;
+    std::string parameters;
+    std::vector<FrameSample> samples;
+};
+
+// Wraps an example app, timing each frame from one update to the next so that the whole
+// drawFrame is included.
+template <typename App> class BenchApp {
+public:
+    BenchApp(App& app, Profiler& profiler, uint32_t totalFrames)
+        : app(app), profiler(profiler), samples(totalFrames) {}
+
+    void init(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height) {
+        app.init(vulkanState, window, width, height);
+    }
+
+    void update(VulkanState& vulkanState) {
+        Clock::time_point time = Clock::now();
+        uint64_t allocationCount = allocationCounter::getAllocationCount();
+
+        // Samples are written in place so that the bench itself doesn't allocate while measuring.
+        if (frame > 0 && frame <= samples.size()) {
+            FrameSample& sample = samples[frame - 1];
+            sample.cpuMilliseconds =
+                std::chrono::duration<double, std::milli>(time - lastTime).count();
+            sample.allocations = allocationCount - lastAllocationCount;
+        }
+
+        uint64_t profiledFrames = profiler.getFrameCount();
+        if (profiledFrames > maxFramesInFlight) {
+            readGpuTimes(profiledFrames - maxFramesInFlight);
+        }
+
+        frame++;
+        lastTime = Clock::now();
+        lastAllocationCount = allocationCounter::getAllocationCount();
+
+        app.update(vulkanState);
+    }
+
+    void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                uint32_t currentFrame) {
+        app.render(vulkanState, commandBuffer, imageIndex, currentFrame);
+    }
+
+    void resize(VulkanState& vulkanState, int32_t width, int32_t height) {
+        app.resize(vulkanState, width, height);
+    }
+
+    // The device is idle by the time cleanup runs, so the remaining GPU results can be read.
+    void cleanup(VulkanState& vulkanState) {
+        profiler.collectPending();
+        readGpuTimes(profiler.getFrameCount());
+
+        app.cleanup(vulkanState);
+    }
+
+    const std::vector<FrameSample>& getSamples() { return samples; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // A frame's GPU results are guaranteed to be read back once its query pool has been reused.
+    void readGpuTimes(uint64_t availableFrames) {
+        for (; nextGpuFrame < availableFrames; nextGpuFrame++) {
+            const FrameProfile* profile = profiler.getFrame(nextGpuFrame);
+            if (profile == nullptr || nextGpuFrame >= samples.size())
+                continue;
+
+            samples[nextGpuFrame].gpuMilliseconds = profile->gpuMilliseconds;
+            samples[nextGpuFrame].gpuValid = profile->gpuValid;
+        }
+    }
+
+    App& app;
+    Profiler& profiler;
+    std::vector<FrameSample> samples;
+    uint32_t frame = 0;
+    uint64_t nextGpuFrame = 0;
+    Clock::time_point lastTime;
+    uint64_t lastAllocationCount = 0;
+};
+
+template <typename App>
+std::vector<FrameSample> runScene(App& app, const BenchOptions& options) {
+    uint32_t totalFrames = options.warmupFrames + options.measuredFrames;
+
+    Renderer renderer;
+    renderer.getProfiler().setEnabled(true);
+
+    BenchApp<App> benchApp(app, renderer.getProfiler(), totalFrames);
+
+    // One extra frame is run so that the last measured frame has an update after it.
+    renderer.runHeadless(benchApp, options.width, options.height, maxFramesInFlight,
+                         totalFrames + 1);
+
+    const std::vector<FrameSample>& samples = benchApp.getSamples();
+    return std::vector<FrameSample>(samples.begin() + options.warmupFrames, samples.end());
+}
+
+// Nearest-rank percentile of already sorted values.
+double percentile(const std::vector<double>& sortedValues, double percent) {
+    if (sortedValues.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sortedValues.size()));
+    return sortedValues[std::max<size_t>(rank, 1) - 1];
+}
+
+void writeStats(std::ostream& output, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+
+    double mean = 0.0;
+    for (double value : values) {
+        mean += value;
+    }
+    if (!values.empty()) {
+        mean /= values.size();
+    }
+
+    output << "{\"p50\":" << percentile(values, 50.0) << ",\"p95\":" << percentile(values, 95.0)
+           << ",\"p99\":" << percentile(values, 99.0) << ",\"mean\":" << mean
+           << ",\"samples\":" << values.size() << "}";
+}
+
+void writeResults(std::ostream& output, const BenchOptions& options,
+                  const std::vector<SceneResult>& results) {
+    output << "{\n  \"width\": " << options.width << ",\n  \"height\": " << options.height
+           << ",\n  \"warmupFrames\": " << options.warmupFrames
+           << ",\n  \"measuredFrames\": " << options.measuredFrames << ",\n  \"scenes\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const SceneResult& result = results[i];
+
+        std::vector<double> cpuTimes;
+        std::vector<double> gpuTimes;
+        uint64_t totalAllocations = 0;
+        uint64_t maxAllocations = 0;
+
+        for (const FrameSample& sample : result.samples) {
+            cpuTimes.push_back(sample.cpuMilliseconds);
+            if (sample.gpuValid) {
+                gpuTimes.push_back(sample.gpuMilliseconds);
+            }
+            totalAllocations += sample.allocations;
+            maxAllocations = std::max(maxAllocations, sample.allocations);
+        }
+
+        double meanAllocations =
+            result.samples.empty() ? 0.0
+                                   : static_cast<double>(totalAllocations) / result.samples.size();
+
+        output << (i == 0 ? "\n" : ",\n");
+        output << "    {\n      \"name\": \"" << result.name << "\",\n      \"parameters\": {"
+               << result.parameters << "},\n      \"cpuFrameMs\": ";
+        writeStats(output, cpuTimes);
+        output << ",\n      \"gpuFrameMs\": ";
+        writeStats(output, gpuTimes);
+        output << ",\n      \"allocationsPerFrame\": {\"mean\":" << meanAllocations
+               << ",\"max\":" << maxAllocations << "}\n    }";
+    }
+
+    output << "\n  ]\n}\n";
+}
+
+// Reports every scene with a measured frame over the allocation limit, returns false if any did.
+bool checkAllocations(const BenchOptions& options, const std::vector<SceneResult>& results) {
+    if (options.maxAllocations < 0)
+        return true;
+
+    bool passed = true;
+    for (const SceneResult& result : results) {
+        for (size_t i = 0; i < result.samples.size(); i++) {
+            uint64_t allocations = result.samples[i].allocations;
+            if (allocations > static_cast<uint64_t>(options.maxAllocations)) {
+                std::cerr << "Scene " << result.name << " made " << allocations
+                          << " heap allocations in measured frame " << i << std::endl;
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    return passed;
+}
+
+void printUsage() {
+    std::cerr << "Usage: vkFrameBench [options]\n"
+                 "  --scene <all|update|cubes|renderTexture|2d>  Scene to run (default all)\n"
+                 "  --warmup <frames>     Frames run before measuring (default 60)\n"
+                 "  --frames <frames>     Frames measured (default 600)\n"
+                 "  --width <pixels>      Render width (default 640)\n"
+                 "  --height <pixels>     Render height (default 480)\n"
+                 "  --sprites <count>     Sprites drawn by the 2d scene (default 2)\n"
+                 "  --map-size <size>     Voxel map size of the cubes scene (default 4)\n"
+                 "  --instances <count>   Instances drawn by the update and renderTexture "
+                 "scenes\n"
+                 "  --output <path>       Write the JSON report to a file instead of stdout\n"
+                 "  --max-allocations <count>  Exit with an error if a measured frame makes more "
+                 "heap allocations (default 0, -1 disables the check)\n";
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help") {
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+
+        if (arg == "--scene") {
+            options.scene = value;
+        } else if (arg == "--warmup") {
+            options.warmupFrames = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--frames") {
+            options.measuredFrames = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--width") {
+            options.width = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--height") {
+            options.height = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--sprites") {
+            options.spriteCount = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--map-size") {
+            options.mapSize = static_cast<int32_t>(std::stoi(value));
+        } else if (arg == "--instances") {
+            options.instanceCount = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--output") {
+            options.outputPath = value;
+        } else if (arg == "--max-allocations") {
+            options.maxAllocations = static_cast<int64_t>(std::stoll(value));
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option value: " << e.what() << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    bool runAll = options.scene == "all";
+    std::vector<SceneResult> results;
+
+    try {
+        if (runAll || options.scene == "update") {
+            uint32_t instanceCount = options.instanceCount > 0 ? options.instanceCount : 3;
+            examples::update::App app(instanceCount);
+            results.push_back(SceneResult{"update",
+                                          "\"instances\":" + std::to_string(instanceCount),
+                                          runScene(app, options)});
+        }
+
+        if (runAll || options.scene == "cubes") {
+            examples::cubes::App app(options.mapSize);
+            results.push_back(SceneResult{"cubes",
+                                          "\"mapSize\":" + std::to_string(options.mapSize),
+                                          runScene(app, options)});
+        }
+
+        if (runAll || options.scene == "renderTexture") {
+            uint32_t instanceCount = options.instanceCount > 0 ? options.instanceCount : 2;
+            examples::renderTexture::App app(instanceCount);
+            results.push_back(SceneResult{"renderTexture",
+                                          "\"instances\":" + std::to_string(instanceCount),
+                                          runScene(app, options)});
+        }
+
+        if (runAll || options.scene == "2d") {
+            examples::sprites::App app(options.spriteCount);
+            results.push_back(SceneResult{"2d",
+                                          "\"sprites\":" + std::to_string(options.spriteCount),
+                                          runScene(app, options)});
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (results.empty()) {
+        std::cerr << "Unknown scene " << options.scene << std::endl;
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (options.outputPath.empty()) {
+        writeResults(std::cout, options, results);
+    } else {
+        std::ofstream file(options.outputPath);
+
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file!" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        writeResults(file, options, results);
+    }
+
+    if (!checkAllocations(options, results)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+
+#include "../vkFrame/renderer.hpp"
+
+/*
+ * 2d:
+ * Render 2d sprites.
+ */
+
+namespace examples::sprites {
+
+struct VertexData {
+    glm::vec3 pos;
+    glm::vec3 color;
+    glm::vec2 texCoord;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(VertexData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(VertexData, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(VertexData, color);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(VertexData, texCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+struct InstanceData {
+public:
+    glm::vec3 pos;
+    glm::vec2 size;
+    glm::vec2 texPos;
+    glm::vec2 texSize;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return bindingDescription;
+    }
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+        attributeDescriptions.resize(4);
+
+        attributeDescriptions[0].binding = 1;
+        attributeDescriptions[0].location = 3;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(InstanceData, pos);
+
+        attributeDescriptions[1].binding = 1;
+        attributeDescriptions[1].location = 4;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(InstanceData, size);
+
+        attributeDescriptions[2].binding = 1;
+        attributeDescriptions[2].location = 5;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(InstanceData, texPos);
+
+        attributeDescriptions[3].binding = 1;
+        attributeDescriptions[3].location = 6;
+        attributeDescriptions[3].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[3].offset = offsetof(InstanceData, texSize);
+
+        return attributeDescriptions;
+    }
+};
+
+struct UniformBufferData {
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+};
+
+const std::vector<VertexData> spriteVertices = {
+    {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}},
+    {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}},
+    {{1.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
+    {{0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},
+};
+
+const std::vector<uint16_t> spriteIndices = {0, 2, 1, 0, 3, 2};
+
+class SpriteBatch {
+private:
+    Model<VertexData, uint16_t, InstanceData> spriteModel;
+    std::vector<InstanceData> instances;
+    Image textureImage;
+    VkImageView textureImageView;
+    VkSampler textureSampler;
+    size_t maxSprites = 0;
+    float inverseImageWidth = 0.0f;
+    float inverseImageHeight = 0.0f;
+
+public:
+    void init(VulkanState& vulkanState, const std::string &image, size_t maxSprites) {
+        this->maxSprites = maxSprites;
+        // Reserved up front so that adding sprites never allocates while rendering.
+        instances.reserve(maxSprites);
+
+        UploadBatch uploadBatch;
+        uploadBatch.begin(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue,
+                          vulkanState.device, vulkanState.memoryBudget);
+
+        textureImage = Image::createTexture(image, uploadBatch, false, vulkanState.mipCache);
+        textureImageView = textureImage.createTextureView(vulkanState.device);
+        textureSampler = Image::createTextureSampler(*vulkanState.samplerCache, VK_FILTER_NEAREST,
+                                                     VK_FILTER_NEAREST);
+
+        inverseImageWidth = 1.0f / textureImage.getWidth();
+        inverseImageHeight = 1.0f / textureImage.getHeight();
+
+        spriteModel = Model<VertexData, uint16_t, InstanceData>::fromVerticesAndIndices(
+            spriteVertices, spriteIndices, maxSprites, vulkanState.maxFramesInFlight,
+            *vulkanState.geometryArena, uploadBatch);
+        uploadBatch.submit();
+    }
+
+    void begin(VulkanState& vulkanState) { instances.clear(); }
+
+    void add(float x, float y, float depth, float sizeX, float sizeY, float texX, float texY, float texWidth, float texHeight) {
+        instances.push_back(InstanceData{
+            glm::vec3(x, y, depth),
+            glm::vec2(sizeX, sizeY),
+            glm::vec2(texX * inverseImageWidth, texY * inverseImageHeight),
+            glm::vec2(texWidth * inverseImageWidth, texHeight * inverseImageHeight)
+        });
+    }
+
+    void end(VulkanState& vulkanState) {
+        spriteModel.updateInstances(instances, vulkanState.commands, vulkanState.allocator);
+    }
+
+    void draw(const VkCommandBuffer& commandBuffer) {
+        spriteModel.draw(commandBuffer);
+    }
+
+    void cleanup(VulkanState& vulkanState) {
+        vulkanState.samplerCache->release(textureSampler);
+        vkDestroyImageView(vulkanState.device, textureImageView, nullptr);
+        textureImage.destroy(vulkanState.allocator);
+
+        spriteModel.destroy(vulkanState.allocator);
+    }
+
+    const VkImageView& getView() { return textureImageView; }
+
+    const VkSampler& getSampler() { return textureSampler; }
+};
+
+class App {
+private:
+    Pipeline pipeline;
+    RenderPass renderPass;
+
+    UniformBuffer<UniformBufferData> ubo;
+
+    std::vector<VkClearValue> clearValues;
+
+    SpriteBatch spriteBatch;
+    uint32_t spriteCount;
+
+public:
+    explicit App(uint32_t spriteCount = 2) : spriteCount(spriteCount) {}
+
+    void init(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height) {
+        vulkanState.swapchain.create(vulkanState.device, vulkanState.physicalDevice,
+                                     vulkanState.surface, width, height);
+
+        vulkanState.commands.createPool(vulkanState.device, vulkanState.queueFamilyIndices);
+        vulkanState.commands.createBuffers(vulkanState.device, vulkanState.maxFramesInFlight);
+
+        ubo.create(vulkanState.maxFramesInFlight, vulkanState.allocator, vulkanState.memoryBudget);
+
+        spriteBatch.init(vulkanState, "res/cubesImg.png", std::max<size_t>(30, spriteCount));
+
+        renderPass.create(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                          vulkanState.swapchain, true, true, vulkanState.memoryBudget);
+        renderPass.setProfiler(vulkanState.profiler);
+
+        pipeline.createDescriptorSetLayout(
+            vulkanState.device, [&](std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+                VkDescriptorSetLayoutBinding uboLayoutBinding{};
+                uboLayoutBinding.binding = 0;
+                uboLayoutBinding.descriptorCount = 1;
+                uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                uboLayoutBinding.pImmutableSamplers = nullptr;
+                uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+                VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+                samplerLayoutBinding.binding = 1;
+                samplerLayoutBinding.descriptorCount = 1;
+                samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                samplerLayoutBinding.pImmutableSamplers = nullptr;
+                samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+                bindings.push_back(uboLayoutBinding);
+                bindings.push_back(samplerLayoutBinding);
+            });
+        pipeline.createDescriptorPool(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkDescriptorPoolSize> poolSizes) {
+                poolSizes.resize(2);
+                poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                poolSizes[0].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+                poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                poolSizes[1].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+            });
+        pipeline.createDescriptorSets(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkWriteDescriptorSet>& descriptorWrites, VkDescriptorSet descriptorSet,
+                uint32_t i) {
+                VkDescriptorBufferInfo bufferInfo{};
+                bufferInfo.buffer = ubo.getBuffer(i);
+                bufferInfo.offset = 0;
+                bufferInfo.range = ubo.getDataSize();
+
+                VkDescriptorImageInfo imageInfo{};
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imageInfo.imageView = spriteBatch.getView();
+                imageInfo.sampler = spriteBatch.getSampler();
+
+                descriptorWrites.resize(2);
+
+                descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[0].dstSet = descriptorSet;
+                descriptorWrites[0].dstBinding = 0;
+                descriptorWrites[0].dstArrayElement = 0;
+                descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                descriptorWrites[0].descriptorCount = 1;
+                descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+                descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[1].dstSet = descriptorSet;
+                descriptorWrites[1].dstBinding = 1;
+                descriptorWrites[1].dstArrayElement = 0;
+                descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                descriptorWrites[1].descriptorCount = 1;
+                descriptorWrites[1].pImageInfo = &imageInfo;
+
+                vkUpdateDescriptorSets(vulkanState.device,
+                                       static_cast<uint32_t>(descriptorWrites.size()),
+                                       descriptorWrites.data(), 0, nullptr);
+            });
+        pipeline.setPipelineCache(vulkanState.pipelineCache);
+        pipeline.create<VertexData, InstanceData>("res/2dShader.vert.spv", "res/2dShader.frag.spv",
+                                                  vulkanState.device, renderPass, false);
+
+        clearValues.resize(2);
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+    }
+
+    void update(VulkanState& vulkanState) {
+        spriteBatch.begin(vulkanState);
+
+        spriteBatch.add(0, 0, 0, 32, 16, 0, 16, 32, 16);
+        spriteBatch.add(16, 0, -1, 64, 32, 0, 16, 32, 16);
+
+        // Any extra sprites are laid out in a grid of 16x16 tiles.
+        for (uint32_t i = 2; i < spriteCount; i++) {
+            float x = static_cast<float>((i % 40) * 16);
+            float y = static_cast<float>((i / 40 % 30) * 16);
+            spriteBatch.add(x, y, -2, 16, 16, 0, 16, 16, 16);
+        }
+
+        spriteBatch.end(vulkanState);
+    }
+
+    void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                uint32_t currentFrame) {
+        const VkExtent2D& extent = vulkanState.swapchain.getExtent();
+
+        static auto startTime = std::chrono::high_resolution_clock::now();
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float time =
+            std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime)
+                .count();
+
+        UniformBufferData uboData{};
+        uboData.model = glm::mat4(1.0f);
+        uboData.view = glm::lookAt(glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
+                                   glm::vec3(0.0f, 1.0f, 0.0f));
+        uboData.proj = glm::ortho(0.0f, static_cast<float>(extent.width), 0.0f,
+                                  static_cast<float>(extent.height), 0.1f, 10.0f);
+
+        ubo.update(uboData, currentFrame);
+
+        vulkanState.commands.beginBuffer(currentFrame);
+
+        renderPass.begin(imageIndex, commandBuffer, extent, clearValues);
+        pipeline.bind(commandBuffer, currentFrame);
+
+        spriteBatch.draw(commandBuffer);
+
+        renderPass.end(commandBuffer);
+
+        vulkanState.commands.endBuffer(currentFrame);
+    }
+
+    void resize(VulkanState& vulkanState, int32_t width, int32_t height) {
+        renderPass.recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                            vulkanState.swapchain, vulkanState.deletionQueue);
+    }
+
+    void cleanup(VulkanState& vulkanState) {
+        pipeline.cleanup(vulkanState.device);
+        renderPass.cleanup(vulkanState.allocator, vulkanState.device);
+
+        ubo.destroy(vulkanState.allocator);
+
+        spriteBatch.cleanup(vulkanState);
+    }
+
+    int run(uint32_t headlessFrames) {
+        Renderer renderer;
+
+        try {
+            if (headlessFrames > 0) {
+                renderer.runHeadless(*this, 640, 480, 2, headlessFrames);
+            } else {
+                renderer.run(*this, "2d", 640, 480, 2);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+};
+
+} // namespace examples::sprites
\ No newline at end of file
@@ -0,0 +1,485 @@
+#pragma once
+
+#include "../vkFrame/renderer.hpp"
+
+/*
+ * Cubes:
+ * Generate a small voxel mesh. The cubes were a lie, there aren't really any cubes. Every slab of
+ * the map is its own model, and the slabs are drawn from secondary command buffers recorded in
+ * parallel.
+ */
+
+namespace examples::cubes {
+
+struct VertexData {
+    glm::vec3 pos;
+    glm::vec3 color;
+    glm::vec3 texCoord;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(VertexData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(VertexData, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(VertexData, color);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(VertexData, texCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+struct InstanceData {
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return bindingDescription;
+    }
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+        return attributeDescriptions;
+    }
+};
+
+struct UniformBufferData {
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+};
+
+const int32_t patternSize = 4;
+
+// Larger maps are filled by tiling this pattern.
+const std::array<int32_t, patternSize* patternSize* patternSize> voxelPattern = {
+    1, 0, 0, 0, 0, 4, 0, 0, 0, 0, 3, 0, 0, 0, 0, 2,
+
+    0, 0, 0, 1, 0, 0, 3, 0, 0, 4, 0, 0, 2, 0, 0, 0,
+
+    3, 2, 1, 4, 2, 0, 0, 1, 1, 0, 0, 2, 4, 1, 2, 3,
+
+    0, 0, 0, 0, 0, 1, 2, 0, 0, 4, 3, 0, 0, 0, 0, 0,
+};
+
+const std::array<std::array<glm::vec3, 4>, 6> cubeVertices = {{
+    // Forward
+    {
+        glm::vec3(0, 0, 0),
+        glm::vec3(0, 1, 0),
+        glm::vec3(1, 1, 0),
+        glm::vec3(1, 0, 0),
+    },
+    // Backward
+    {
+        glm::vec3(0, 0, 1),
+        glm::vec3(0, 1, 1),
+        glm::vec3(1, 1, 1),
+        glm::vec3(1, 0, 1),
+    },
+    // Right
+    {
+        glm::vec3(1, 0, 0),
+        glm::vec3(1, 0, 1),
+        glm::vec3(1, 1, 1),
+        glm::vec3(1, 1, 0),
+    },
+    // Left
+    {
+        glm::vec3(0, 0, 0),
+        glm::vec3(0, 0, 1),
+        glm::vec3(0, 1, 1),
+        glm::vec3(0, 1, 0),
+    },
+    // Up
+    {
+        glm::vec3(0, 1, 0),
+        glm::vec3(0, 1, 1),
+        glm::vec3(1, 1, 1),
+        glm::vec3(1, 1, 0),
+    },
+    // Down
+    {
+        glm::vec3(0, 0, 0),
+        glm::vec3(0, 0, 1),
+        glm::vec3(1, 0, 1),
+        glm::vec3(1, 0, 0),
+    },
+}};
+
+const std::array<std::array<glm::vec2, 4>, 6> cubeUvs = {{
+    // Forward
+    {
+        glm::vec2(1, 1),
+        glm::vec2(1, 0),
+        glm::vec2(0, 0),
+        glm::vec2(0, 1),
+    },
+    // Backward
+    {
+        glm::vec2(0, 1),
+        glm::vec2(0, 0),
+        glm::vec2(1, 0),
+        glm::vec2(1, 1),
+    },
+    // Right
+    {
+        glm::vec2(1, 1),
+        glm::vec2(0, 1),
+        glm::vec2(0, 0),
+        glm::vec2(1, 0),
+    },
+    // Left
+    {
+        glm::vec2(0, 1),
+        glm::vec2(1, 1),
+        glm::vec2(1, 0),
+        glm::vec2(0, 0),
+    },
+    // Up
+    {
+        glm::vec2(0, 1),
+        glm::vec2(0, 0),
+        glm::vec2(1, 0),
+        glm::vec2(1, 1),
+    },
+    // Down
+    {
+        glm::vec2(0, 1),
+        glm::vec2(0, 0),
+        glm::vec2(1, 0),
+        glm::vec2(1, 1),
+    },
+}};
+
+const std::array<std::array<uint16_t, 6>, 6> cubeIndices = {{
+    {0, 1, 2, 0, 2, 3}, // Forward
+    {0, 2, 1, 0, 3, 2}, // Backward
+    {0, 2, 1, 0, 3, 2}, // Right
+    {0, 1, 2, 0, 2, 3}, // Left
+    {0, 1, 2, 0, 2, 3}, // Up
+    {0, 2, 1, 0, 3, 2}, // Down
+}};
+
+const std::array<std::array<int32_t, 3>, 6> directions = {{
+    {0, 0, -1}, // Forward
+    {0, 0, 1},  // Backward
+    {1, 0, 0},  // Right
+    {-1, 0, 0}, // Left
+    {0, 1, 0},  // Up
+    {0, -1, 0}, // Down
+}};
+
+class App {
+private:
+    Pipeline pipeline;
+    RenderPass renderPass;
+
+    Image textureImage;
+    VkImageView textureImageView;
+    VkSampler textureSampler;
+
+    UniformBuffer<UniformBufferData> ubo;
+    // One model per slab of the map along x, empty slabs are skipped.
+    std::vector<Model<VertexData, uint32_t, InstanceData>> slabModels;
+    ParallelCommands parallelCommands;
+    uint32_t taskCount = 0;
+
+    std::vector<VertexData> voxelVertices;
+    std::vector<uint32_t> voxelIndices;
+    std::vector<VkClearValue> clearValues;
+
+    size_t mapSize;
+
+public:
+    explicit App(int32_t mapSize = patternSize) : mapSize(static_cast<size_t>(mapSize)) {}
+
+    int32_t getVoxel(size_t x, size_t y, size_t z) {
+        // Negative coordinates wrap around to large values and are caught here too.
+        if (x >= mapSize || y >= mapSize || z >= mapSize) {
+            return 0;
+        }
+
+        x %= patternSize;
+        y %= patternSize;
+        z %= patternSize;
+
+        return voxelPattern[x + y * patternSize + z * patternSize * patternSize];
+    }
+
+    // Replaces voxelVertices and voxelIndices with the mesh of the slab at x.
+    void generateVoxelMesh(size_t x) {
+        voxelVertices.clear();
+        voxelIndices.clear();
+
+        for (size_t y = 0; y < mapSize; y++)
+            for (size_t z = 0; z < mapSize; z++) {
+                int32_t voxel = getVoxel(x, y, z);
+
+                if (voxel == 0)
+                    continue;
+
+                for (size_t face = 0; face < 6; face++) {
+                    if (getVoxel(x + directions[face][0], y + directions[face][1],
+                                 z + directions[face][2]) != 0)
+                        continue;
+
+                    size_t vertexCount = voxelVertices.size();
+                    for (uint16_t index : cubeIndices[face]) {
+                        voxelIndices.push_back(index + vertexCount);
+                    }
+
+                    for (size_t i = 0; i < 4; i++) {
+                        glm::vec3 vertex = cubeVertices[face][i];
+                        glm::vec2 uv = cubeUvs[face][i];
+
+                        voxelVertices.push_back(VertexData{
+                            vertex + glm::vec3(x, y, z),
+                            glm::vec3(1.0, 1.0, 1.0),
+                            glm::vec3(uv.x, uv.y, voxel - 1),
+                        });
+                    }
+                }
+            }
+    }
+
+    void init(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height) {
+        vulkanState.swapchain.create(vulkanState.device, vulkanState.physicalDevice,
+                                     vulkanState.surface, width, height);
+
+        vulkanState.commands.createPool(vulkanState.device, vulkanState.queueFamilyIndices);
+        vulkanState.commands.createBuffers(vulkanState.device, vulkanState.maxFramesInFlight);
+
+        // The texture and mesh are uploaded together with a single submission.
+        UploadBatch uploadBatch;
+        uploadBatch.begin(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue,
+                          vulkanState.device, vulkanState.memoryBudget);
+
+        textureImage = Image::createTextureArray("res/cubesImg.png", uploadBatch, true, 16, 16, 4,
+                                                 vulkanState.mipCache);
+        textureImageView = textureImage.createTextureView(vulkanState.device);
+        textureSampler = Image::createTextureSampler(*vulkanState.samplerCache, VK_FILTER_NEAREST,
+                                                     VK_FILTER_NEAREST);
+
+        for (size_t x = 0; x < mapSize; x++) {
+            generateVoxelMesh(x);
+            if (voxelIndices.empty())
+                continue;
+
+            slabModels.push_back(Model<VertexData, uint32_t, InstanceData>::fromVerticesAndIndices(
+                voxelVertices, voxelIndices, 1, vulkanState.maxFramesInFlight,
+                *vulkanState.geometryArena, uploadBatch));
+        }
+        uploadBatch.submit();
+        std::vector<InstanceData> instances = {InstanceData{}};
+        for (auto& slabModel : slabModels) {
+            slabModel.updateInstances(instances, vulkanState.commands, vulkanState.allocator);
+        }
+
+        // Each worker records a run of slabs into its own secondary command buffer.
+        parallelCommands.create(vulkanState.device, vulkanState.queueFamilyIndices,
+                                vulkanState.maxFramesInFlight, *vulkanState.workerPool);
+        taskCount = std::min(parallelCommands.getWorkerCount(),
+                             static_cast<uint32_t>(slabModels.size()));
+        parallelCommands.reserve(taskCount);
+
+        const VkExtent2D& extent = vulkanState.swapchain.getExtent();
+        ubo.create(vulkanState.maxFramesInFlight, vulkanState.allocator, vulkanState.memoryBudget);
+
+        renderPass.create(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                          vulkanState.swapchain, true, false, vulkanState.memoryBudget);
+        renderPass.setProfiler(vulkanState.profiler);
+
+        pipeline.createDescriptorSetLayout(
+            vulkanState.device, [&](std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+                VkDescriptorSetLayoutBinding uboLayoutBinding{};
+                uboLayoutBinding.binding = 0;
+                uboLayoutBinding.descriptorCount = 1;
+                uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                uboLayoutBinding.pImmutableSamplers = nullptr;
+                uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+                VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+                samplerLayoutBinding.binding = 1;
+                samplerLayoutBinding.descriptorCount = 1;
+                samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                samplerLayoutBinding.pImmutableSamplers = nullptr;
+                samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+                bindings.push_back(uboLayoutBinding);
+                bindings.push_back(samplerLayoutBinding);
+            });
+        pipeline.createDescriptorPool(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkDescriptorPoolSize> poolSizes) {
+                poolSizes.resize(2);
+                poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                poolSizes[0].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+                poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                poolSizes[1].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+            });
+        pipeline.createDescriptorSets(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkWriteDescriptorSet>& descriptorWrites, VkDescriptorSet descriptorSet,
+                uint32_t i) {
+                VkDescriptorBufferInfo bufferInfo{};
+                bufferInfo.buffer = ubo.getBuffer(i);
+                bufferInfo.offset = 0;
+                bufferInfo.range = ubo.getDataSize();
+
+                VkDescriptorImageInfo imageInfo{};
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imageInfo.imageView = textureImageView;
+                imageInfo.sampler = textureSampler;
+
+                descriptorWrites.resize(2);
+
+                descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[0].dstSet = descriptorSet;
+                descriptorWrites[0].dstBinding = 0;
+                descriptorWrites[0].dstArrayElement = 0;
+                descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                descriptorWrites[0].descriptorCount = 1;
+                descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+                descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[1].dstSet = descriptorSet;
+                descriptorWrites[1].dstBinding = 1;
+                descriptorWrites[1].dstArrayElement = 0;
+                descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                descriptorWrites[1].descriptorCount = 1;
+                descriptorWrites[1].pImageInfo = &imageInfo;
+
+                vkUpdateDescriptorSets(vulkanState.device,
+                                       static_cast<uint32_t>(descriptorWrites.size()),
+                                       descriptorWrites.data(), 0, nullptr);
+            });
+        // Compiles in the background, frames are only cleared until it is ready.
+        pipeline.setPipelineCache(vulkanState.pipelineCache);
+        pipeline.createAsync<VertexData, InstanceData>(
+            "res/cubesShader.vert.spv", "res/cubesShader.frag.spv", vulkanState.device,
+            renderPass, false, *vulkanState.workerPool);
+        // Headless runs are benchmarks, every frame they measure should draw the voxels and none
+        // should overlap the compile's allocations.
+        if (window == nullptr) {
+            pipeline.waitUntilReady();
+        }
+
+        clearValues.resize(2);
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+    }
+
+    void update(VulkanState& vulkanState) {}
+
+    void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                uint32_t currentFrame) {
+        const VkExtent2D& extent = vulkanState.swapchain.getExtent();
+
+        UniformBufferData uboData{};
+        uboData.model =
+            glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        // Keep the whole map in view as it grows.
+        float distance = 2.5f * mapSize;
+        uboData.view = glm::lookAt(glm::vec3(distance, distance, distance),
+                                   glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        uboData.proj = glm::perspective(glm::radians(45.0f), extent.width / (float)extent.height,
+                                        0.1f, 2.0f * distance);
+        uboData.proj[1][1] *= -1;
+
+        ubo.update(uboData, currentFrame);
+
+        vulkanState.commands.beginBuffer(currentFrame);
+        parallelCommands.beginFrame(currentFrame);
+
+        renderPass.begin(imageIndex, commandBuffer, extent, clearValues,
+                         VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        if (pipeline.isReady()) {
+            GeometryArena& geometryArena = *vulkanState.geometryArena;
+            size_t slabCount = slabModels.size();
+
+            auto recordSlabs = [&](VkCommandBuffer secondaryBuffer, uint32_t taskIndex) {
+                pipeline.bind(secondaryBuffer, currentFrame);
+                geometryArena.bind(secondaryBuffer,
+                                   Model<VertexData, uint32_t, InstanceData>::getIndexType());
+
+                size_t firstSlab = slabCount * taskIndex / taskCount;
+                size_t lastSlab = slabCount * (taskIndex + 1) / taskCount;
+                for (size_t slab = firstSlab; slab < lastSlab; slab++) {
+                    slabModels[slab].drawBound(secondaryBuffer);
+                }
+            };
+
+            parallelCommands.record(commandBuffer, renderPass, imageIndex, extent, taskCount,
+                                    recordSlabs);
+        }
+
+        renderPass.end(commandBuffer);
+
+        vulkanState.commands.endBuffer(currentFrame);
+    }
+
+    void resize(VulkanState& vulkanState, int32_t width, int32_t height) {
+        renderPass.recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                            vulkanState.swapchain, vulkanState.deletionQueue);
+    }
+
+    void cleanup(VulkanState& vulkanState) {
+        pipeline.cleanup(vulkanState.device);
+        renderPass.cleanup(vulkanState.allocator, vulkanState.device);
+
+        ubo.destroy(vulkanState.allocator);
+
+        vulkanState.samplerCache->release(textureSampler);
+        vkDestroyImageView(vulkanState.device, textureImageView, nullptr);
+        textureImage.destroy(vulkanState.allocator);
+
+        for (auto& slabModel : slabModels) {
+            slabModel.destroy(vulkanState.allocator);
+        }
+        slabModels.clear();
+
+        parallelCommands.destroy(vulkanState.device);
+    }
+
+    int run(uint32_t headlessFrames) {
+        Renderer renderer;
+
+        try {
+            if (headlessFrames > 0) {
+                renderer.runHeadless(*this, 640, 480, 2, headlessFrames);
+            } else {
+                renderer.run(*this, "Cubes", 640, 480, 2);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+};
+
+} // namespace examples::cubes
\ No newline at end of file
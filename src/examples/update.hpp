@@ -0,0 +1,334 @@
+#pragma once
+
+#include "../vkFrame/renderer.hpp"
+
+/*
+ * Update:
+ * Make a model that swaps between 2 meshes and has 3 instances. Its texture streams in a mip
+ * level at a time.
+ */
+
+namespace examples::update {
+
+struct VertexData {
+    glm::vec3 pos;
+    glm::vec3 color;
+    glm::vec2 texCoord;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(VertexData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(VertexData, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(VertexData, color);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(VertexData, texCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+struct InstanceData {
+public:
+    glm::vec3 pos;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return bindingDescription;
+    }
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+        attributeDescriptions.resize(1);
+
+        attributeDescriptions[0].binding = 1;
+        attributeDescriptions[0].location = 3;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = 0;
+
+        return attributeDescriptions;
+    }
+};
+
+struct UniformBufferData {
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+};
+
+const std::vector<VertexData> testVertices = {
+    {{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+    {{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+    {{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+    {{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}},
+
+    {{-0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+    {{0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+    {{0.5f, 0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+    {{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}}};
+
+const std::vector<uint16_t> testIndices = {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4};
+
+const std::vector<VertexData> testVertices2 = {
+    {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+    {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+    {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}}};
+
+const std::vector<uint16_t> testIndices2 = {0, 1, 2};
+
+class App {
+private:
+    Pipeline pipeline;
+    RenderPass renderPass;
+
+    StreamingTexture texture;
+    TextureStreamer textureStreamer;
+    // The resident level each frame's descriptor set was last written with.
+    std::vector<uint32_t> descriptorLevels;
+    VkSampler textureSampler;
+
+    // One transform per frame, selected with a dynamic offset when the pipeline is bound.
+    DynamicUniformBuffer<UniformBufferData> ubo;
+    Model<VertexData, uint16_t, InstanceData> spriteModel;
+
+    uint32_t frameCount = 0;
+    uint32_t instanceCount;
+
+    std::vector<VkClearValue> clearValues;
+
+public:
+    explicit App(uint32_t instanceCount = 3) : instanceCount(instanceCount) {}
+
+    void init(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height) {
+        vulkanState.swapchain.create(vulkanState.device, vulkanState.physicalDevice,
+                                     vulkanState.surface, width, height);
+
+        vulkanState.commands.createPool(vulkanState.device, vulkanState.queueFamilyIndices);
+        vulkanState.commands.createBuffers(vulkanState.device, vulkanState.maxFramesInFlight);
+
+        // Only the levels up to 16 x 16 are uploaded now, the others stream in over the first
+        // frames. The small budget spreads them over several frames.
+        UploadBatch uploadBatch;
+        uploadBatch.begin(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue,
+                          vulkanState.device, vulkanState.memoryBudget);
+        texture.create("res/updateImg.png", uploadBatch, vulkanState.device, vulkanState.mipCache,
+                       16);
+        uploadBatch.submit();
+        textureStreamer.setFrameBudget(4 * 1024);
+        textureStreamer.add(texture);
+        descriptorLevels.assign(vulkanState.maxFramesInFlight, texture.getResidentLevel());
+
+        textureSampler = Image::createTextureSampler(*vulkanState.samplerCache);
+
+        spriteModel = Model<VertexData, uint16_t, InstanceData>::create(
+            instanceCount, vulkanState.maxFramesInFlight, *vulkanState.geometryArena,
+            vulkanState.allocator);
+        std::vector<InstanceData> instances;
+        instances.reserve(instanceCount);
+        for (uint32_t i = 0; i < instanceCount; i++) {
+            // Step along the x, y and z axes in turn, moving further out each lap.
+            glm::vec3 pos(0.0f);
+            pos[i % 3] = 1.0f + static_cast<float>(i / 3);
+            instances.push_back(InstanceData{pos});
+        }
+        spriteModel.updateInstances(instances, vulkanState.commands, vulkanState.allocator);
+
+        ubo.create(vulkanState.physicalDevice, vulkanState.maxFramesInFlight, 1,
+                   vulkanState.allocator, vulkanState.memoryBudget);
+
+        renderPass.create(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                          vulkanState.swapchain, true, true, vulkanState.memoryBudget);
+        renderPass.setProfiler(vulkanState.profiler);
+
+        pipeline.createDescriptorSetLayout(
+            vulkanState.device, [&](std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+                VkDescriptorSetLayoutBinding uboLayoutBinding{};
+                uboLayoutBinding.binding = 0;
+                uboLayoutBinding.descriptorCount = 1;
+                uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                uboLayoutBinding.pImmutableSamplers = nullptr;
+                uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+                VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+                samplerLayoutBinding.binding = 1;
+                samplerLayoutBinding.descriptorCount = 1;
+                samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                samplerLayoutBinding.pImmutableSamplers = nullptr;
+                samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+                bindings.push_back(uboLayoutBinding);
+                bindings.push_back(samplerLayoutBinding);
+            });
+        pipeline.createDescriptorPool(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkDescriptorPoolSize> poolSizes) {
+                poolSizes.resize(2);
+                poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                poolSizes[0].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+                poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                poolSizes[1].descriptorCount = static_cast<uint32_t>(vulkanState.maxFramesInFlight);
+            });
+        pipeline.createDescriptorSets(
+            vulkanState.maxFramesInFlight, vulkanState.device,
+            [&](std::vector<VkWriteDescriptorSet>& descriptorWrites, VkDescriptorSet descriptorSet,
+                uint32_t i) {
+                VkDescriptorBufferInfo bufferInfo{};
+                bufferInfo.buffer = ubo.getBuffer();
+                bufferInfo.offset = 0;
+                bufferInfo.range = ubo.getDataSize();
+
+                VkDescriptorImageInfo imageInfo{};
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imageInfo.imageView = texture.getView();
+                imageInfo.sampler = textureSampler;
+
+                descriptorWrites.resize(2);
+
+                descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[0].dstSet = descriptorSet;
+                descriptorWrites[0].dstBinding = 0;
+                descriptorWrites[0].dstArrayElement = 0;
+                descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                descriptorWrites[0].descriptorCount = 1;
+                descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+                descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[1].dstSet = descriptorSet;
+                descriptorWrites[1].dstBinding = 1;
+                descriptorWrites[1].dstArrayElement = 0;
+                descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                descriptorWrites[1].descriptorCount = 1;
+                descriptorWrites[1].pImageInfo = &imageInfo;
+
+                vkUpdateDescriptorSets(vulkanState.device,
+                                       static_cast<uint32_t>(descriptorWrites.size()),
+                                       descriptorWrites.data(), 0, nullptr);
+            });
+        pipeline.setPipelineCache(vulkanState.pipelineCache);
+        pipeline.create<VertexData, InstanceData>("res/updateShader.vert.spv",
+                                                  "res/updateShader.frag.spv", vulkanState.device,
+                                                  renderPass, false);
+
+        clearValues.resize(2);
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+    }
+
+    void update(VulkanState& vulkanState) {
+        uint32_t animFrame = frameCount / 3000;
+        if (frameCount % 3000 == 0) {
+            if (animFrame % 2 == 0) {
+                spriteModel.update(testVertices2, testIndices2, vulkanState.commands,
+                                   vulkanState.allocator, vulkanState.graphicsQueue,
+                                   vulkanState.device, vulkanState.deletionQueue);
+            } else {
+                spriteModel.update(testVertices, testIndices, vulkanState.commands,
+                                   vulkanState.allocator, vulkanState.graphicsQueue,
+                                   vulkanState.device, vulkanState.deletionQueue);
+            }
+        }
+
+        frameCount++;
+    }
+
+    void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
+                uint32_t currentFrame) {
+        const VkExtent2D& extent = vulkanState.swapchain.getExtent();
+
+        static auto startTime = std::chrono::high_resolution_clock::now();
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float time =
+            std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime)
+                .count();
+
+        UniformBufferData uboData{};
+        uboData.model =
+            glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        uboData.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
+                                   glm::vec3(0.0f, 0.0f, 1.0f));
+        uboData.proj =
+            glm::perspective(glm::radians(45.0f), extent.width / (float)extent.height, 0.1f, 10.0f);
+        uboData.proj[1][1] *= -1;
+
+        ubo.beginFrame(currentFrame);
+        uint32_t uboOffset = ubo.push(uboData);
+
+        vulkanState.commands.beginBuffer(currentFrame);
+
+        textureStreamer.recordUpdates(commandBuffer, vulkanState.commands, vulkanState.allocator,
+                                      vulkanState.device, vulkanState.deletionQueue);
+        // The frame that last used this set has completed, so it can be written again.
+        if (descriptorLevels[currentFrame] != texture.getResidentLevel()) {
+            pipeline.updateDescriptorSet(currentFrame);
+            descriptorLevels[currentFrame] = texture.getResidentLevel();
+        }
+
+        renderPass.begin(imageIndex, commandBuffer, extent, clearValues);
+        pipeline.bind(commandBuffer, currentFrame, {uboOffset});
+
+        spriteModel.draw(commandBuffer);
+
+        renderPass.end(commandBuffer);
+
+        vulkanState.commands.endBuffer(currentFrame);
+    }
+
+    void resize(VulkanState& vulkanState, int32_t width, int32_t height) {
+        renderPass.recreate(vulkanState.physicalDevice, vulkanState.device, vulkanState.allocator,
+                            vulkanState.swapchain, vulkanState.deletionQueue);
+    }
+
+    void cleanup(VulkanState& vulkanState) {
+        pipeline.cleanup(vulkanState.device);
+        renderPass.cleanup(vulkanState.allocator, vulkanState.device);
+
+        ubo.destroy(vulkanState.allocator);
+
+        vulkanState.samplerCache->release(textureSampler);
+        textureStreamer.remove(texture);
+        texture.destroy(vulkanState.device, vulkanState.allocator);
+
+        spriteModel.destroy(vulkanState.allocator);
+    }
+
+    int run(uint32_t headlessFrames) {
+        Renderer renderer;
+
+        try {
+            if (headlessFrames > 0) {
+                renderer.runHeadless(*this, 640, 480, 2, headlessFrames);
+            } else {
+                renderer.run(*this, "Update", 640, 480, 2);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+};
+
+} // namespace examples::update
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../vkFrame/compressedTexture.hpp"
+
+/*
+ * compressedTextureTest:
+ * Writes KTX2 and DDS files holding hand-made blocks of every mode CompressedTexture can decode,
+ * transcodes them and compares texels against values worked out from the format specifications.
+ */
+
+const char* testPath = "compressedTextureTest.bin";
+
+struct Texel {
+    uint32_t x;
+    uint32_t y;
+    uint8_t rgba[4];
+};
+
+using Bytes = std::vector<uint8_t>;
+
+template <typename T> void write(Bytes& file, size_t offset, T value) {
+    memcpy(file.data() + offset, &value, sizeof(T));
+}
+
+void writeFile(const Bytes& contents) {
+    std::ofstream file(testPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(contents.data()),
+               static_cast<std::streamsize>(contents.size()));
+}
+
+// A KTX2 file with one layer and the given levels, base level first.
+Bytes makeKtx2(VkFormat format, uint32_t width, uint32_t height, const std::vector<Bytes>& levels) {
+    const uint8_t identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                    0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    size_t offset = 80 + levels.size() * 24;
+    Bytes file(offset);
+    memcpy(file.data(), identifier, sizeof(identifier));
+    write<uint32_t>(file, 12, static_cast<uint32_t>(format));
+    write<uint32_t>(file, 16, 1);
+    write<uint32_t>(file, 20, width);
+    write<uint32_t>(file, 24, height);
+    write<uint32_t>(file, 36, 1);
+    write<uint32_t>(file, 40, static_cast<uint32_t>(levels.size()));
+
+    for (size_t i = 0; i < levels.size(); i++) {
+        write<uint64_t>(file, 80 + i * 24, offset);
+        write<uint64_t>(file, 80 + i * 24 + 8, levels[i].size());
+        file.insert(file.end(), levels[i].begin(), levels[i].end());
+        offset += levels[i].size();
+    }
+
+    return file;
+}
+
+// A DDS file with a single level in a legacy FourCC format.
+Bytes makeDds(const char* fourCC, uint32_t width, uint32_t height, const Bytes& level) {
+    Bytes file(128);
+    memcpy(file.data(), "DDS ", 4);
+    write<uint32_t>(file, 4, 124);
+    write<uint32_t>(file, 12, height);
+    write<uint32_t>(file, 16, width);
+    write<uint32_t>(file, 28, 1);
+    write<uint32_t>(file, 76, 32);
+    write<uint32_t>(file, 80, 0x4);
+    memcpy(file.data() + 84, fourCC, 4);
+    file.insert(file.end(), level.begin(), level.end());
+
+    return file;
+}
+
+CompressedTexture transcodeFile(const Bytes& contents) {
+    writeFile(contents);
+    CompressedTexture texture = CompressedTexture::fromFile(testPath);
+    texture.transcode();
+
+    return texture;
+}
+
+bool check(const std::string& name, const CompressedTexture& texture, size_t level,
+           const std::vector<Texel>& expected) {
+    const TextureLevel& textureLevel = texture.getLevels()[level];
+    bool passed = true;
+
+    for (const Texel& texel : expected) {
+        const uint8_t* actual =
+            texture.getData().data() + textureLevel.offset +
+            (static_cast<size_t>(texel.y) * textureLevel.width + texel.x) * 4;
+
+        if (memcmp(actual, texel.rgba, 4) != 0) {
+            std::cerr << name << ": texel (" << texel.x << ", " << texel.y << ") of level "
+                      << level << " is (" << +actual[0] << ", " << +actual[1] << ", "
+                      << +actual[2] << ", " << +actual[3] << "), expected (" << +texel.rgba[0]
+                      << ", " << +texel.rgba[1] << ", " << +texel.rgba[2] << ", "
+                      << +texel.rgba[3] << ")" << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool checkBlock(const std::string& name, VkFormat format, const Bytes& block,
+                const std::vector<Texel>& expected) {
+    return check(name, transcodeFile(makeKtx2(format, 4, 4, {block})), 0, expected);
+}
+
+bool testBc1() {
+    // Red and blue endpoints, color0 > color1 selects four colors. Texels 0 to 3 use indices
+    // 0 to 3, the rest index 0.
+    Bytes block = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00};
+
+    return checkBlock("BC1", VK_FORMAT_BC1_RGB_UNORM_BLOCK, block,
+                      {{0, 0, {255, 0, 0, 255}},
+                       {1, 0, {0, 0, 255, 255}},
+                       {2, 0, {170, 0, 85, 255}},
+                       {3, 0, {85, 0, 170, 255}},
+                       {3, 3, {255, 0, 0, 255}}});
+}
+
+bool testBc1TransparentBlack() {
+    // color0 <= color1 selects three colors, index 3 is transparent black. DXT1 is BC1 RGBA.
+    Bytes block = {0x1F, 0x00, 0x00, 0xF8, 0xC4, 0x00, 0x00, 0x00};
+
+    return check("BC1 transparent black", transcodeFile(makeDds("DXT1", 4, 4, block)), 0,
+                 {{0, 0, {0, 0, 255, 255}},
+                  {1, 0, {255, 0, 0, 255}},
+                  {3, 0, {0, 0, 0, 0}},
+                  {0, 1, {0, 0, 255, 255}}});
+}
+
+bool testBc2() {
+    // Explicit alpha i * 17 for texel i. The color block stays in four color mode even though
+    // color0 <= color1.
+    Bytes block = {0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+                   0x00, 0x00, 0xE0, 0x07, 0xE4, 0x00, 0x00, 0x00};
+
+    return checkBlock("BC2", VK_FORMAT_BC2_UNORM_BLOCK, block,
+                      {{0, 0, {0, 0, 0, 0}},
+                       {1, 0, {0, 255, 0, 17}},
+                       {2, 0, {0, 85, 0, 34}},
+                       {3, 0, {0, 170, 0, 51}},
+                       {3, 3, {0, 0, 0, 255}}});
+}
+
+bool testBc4And5() {
+    // Red interpolates 8 values between 70 and 0, green has 6 values between 0 and 100 plus 0
+    // and 255. Texels 0 to 7 use indices 0 to 7, the rest index 0.
+    Bytes red = {70, 0, 0x88, 0xC6, 0xFA, 0x00, 0x00, 0x00};
+    Bytes green = {0, 100, 0x88, 0xC6, 0xFA, 0x00, 0x00, 0x00};
+
+    Bytes bc5 = red;
+    bc5.insert(bc5.end(), green.begin(), green.end());
+
+    bool passed = checkBlock("BC4", VK_FORMAT_BC4_UNORM_BLOCK, red,
+                             {{0, 0, {70, 0, 0, 255}},
+                              {1, 0, {0, 0, 0, 255}},
+                              {2, 0, {60, 0, 0, 255}},
+                              {3, 0, {50, 0, 0, 255}},
+                              {3, 1, {10, 0, 0, 255}},
+                              {3, 3, {70, 0, 0, 255}}});
+
+    passed &= checkBlock("BC5", VK_FORMAT_BC5_UNORM_BLOCK, bc5,
+                         {{1, 0, {0, 100, 0, 255}},
+                          {2, 0, {60, 20, 0, 255}},
+                          {1, 1, {30, 80, 0, 255}},
+                          {2, 1, {20, 0, 0, 255}},
+                          {3, 1, {10, 255, 0, 255}}});
+
+    return passed;
+}
+
+bool testLevels() {
+    // Two BC4 blocks side by side in an 8x4 base level, and a 4x2 level clipping its block.
+    Bytes base = {10, 0, 0, 0, 0, 0, 0, 0, 20, 0, 0, 0, 0, 0, 0, 0};
+    Bytes second = {30, 0, 0, 0, 0, 0, 0, 0};
+
+    CompressedTexture texture =
+        transcodeFile(makeKtx2(VK_FORMAT_BC4_UNORM_BLOCK, 8, 4, {base, second}));
+
+    if (texture.getLevels().size() != 2 || texture.getLevels()[1].width != 4 ||
+        texture.getLevels()[1].height != 2 || texture.getData().size() != (8 * 4 + 4 * 2) * 4) {
+        std::cerr << "Levels: transcoded levels have the wrong layout" << std::endl;
+        return false;
+    }
+
+    bool passed = check("Levels", texture, 0,
+                        {{2, 3, {10, 0, 0, 255}}, {5, 1, {20, 0, 0, 255}}});
+    passed &= check("Levels", texture, 1, {{3, 1, {30, 0, 0, 255}}});
+
+    return passed;
+}
+
+bool testEtc1() {
+    // Individual mode: base colors (8, 4, 2) and (0, 15, 0) side by side, tables 0 and 7.
+    Bytes individual = {0x80, 0x4F, 0x20, 0x1C, 0x10, 0x22, 0x10, 0x30};
+    // Differential mode: base colors (16, 0, 31) and (19, 0, 27) on top of each other, tables 1
+    // and 2.
+    Bytes differential = {0x83, 0x00, 0xFC, 0x2B, 0x80, 0x04, 0x80, 0x20};
+
+    bool passed = checkBlock("ETC1 individual", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, individual,
+                             {{0, 0, {138, 70, 36, 255}},
+                              {1, 0, {144, 76, 42, 255}},
+                              {0, 1, {134, 66, 32, 255}},
+                              {1, 1, {128, 60, 26, 255}},
+                              {2, 0, {47, 255, 47, 255}},
+                              {3, 0, {0, 72, 0, 255}},
+                              {3, 3, {47, 255, 47, 255}}});
+
+    passed &= checkBlock("ETC1 differential", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, differential,
+                         {{0, 0, {137, 5, 255, 255}},
+                          {1, 1, {149, 17, 255, 255}},
+                          {0, 2, {147, 0, 213, 255}},
+                          {3, 3, {127, 0, 193, 255}}});
+
+    return passed;
+}
+
+bool testEtc2Modes() {
+    // T mode, red overflows: colors (10, 3, 12) and (5, 6, 7), distance 32.
+    Bytes tMode = {0xF2, 0x3C, 0x56, 0x7B, 0x00, 0x22, 0x00, 0x30};
+    // H mode, green overflows: colors (4, 9, 2) and (1, 1, 1). The first color is larger, so
+    // the order bit picks distance 32.
+    Bytes hMode = {0x24, 0x15, 0x08, 0x8E, 0x00, 0x22, 0x00, 0x30};
+    // Planar mode, blue overflows: origin (0, 64, 4), horizontal (63, 0, 0) and vertical
+    // (0, 127, 63).
+    Bytes planar = {0x01, 0x00, 0x06, 0x7F, 0x00, 0x00, 0x1F, 0xFF};
+
+    bool passed = checkBlock("ETC2 T mode", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, tMode,
+                             {{0, 0, {170, 51, 204, 255}},
+                              {1, 0, {117, 134, 151, 255}},
+                              {0, 1, {85, 102, 119, 255}},
+                              {1, 1, {53, 70, 87, 255}}});
+
+    passed &= checkBlock("ETC2 H mode", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, hMode,
+                         {{0, 0, {100, 185, 66, 255}},
+                          {1, 0, {36, 121, 2, 255}},
+                          {0, 1, {49, 49, 49, 255}},
+                          {1, 1, {0, 0, 0, 255}}});
+
+    passed &= checkBlock("ETC2 planar", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, planar,
+                         {{0, 0, {0, 129, 16, 255}},
+                          {3, 0, {191, 32, 4, 255}},
+                          {0, 3, {0, 224, 195, 255}},
+                          {3, 3, {191, 127, 183, 255}},
+                          {1, 2, {64, 160, 132, 255}}});
+
+    return passed;
+}
+
+bool testEacAlpha() {
+    // Base 250, multiplier 3, table 13, followed by the individual mode ETC1 block.
+    Bytes block = {0xFA, 0x3D, 0x7C, 0x08, 0x00, 0x00, 0x00, 0x00,
+                   0x80, 0x4F, 0x20, 0x1C, 0x10, 0x22, 0x10, 0x30};
+
+    return checkBlock("EAC alpha", VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, block,
+                      {{0, 0, {138, 70, 36, 220}},
+                       {0, 1, {134, 66, 32, 255}},
+                       {1, 0, {144, 76, 42, 250}},
+                       {3, 3, {47, 255, 47, 247}}});
+}
+
+bool testRejected() {
+    bool passed = true;
+
+    auto expectThrow = [&](const std::string& name, const Bytes& contents) {
+        writeFile(contents);
+        try {
+            CompressedTexture::fromFile(testPath);
+            std::cerr << name << ": loaded without throwing" << std::endl;
+            passed = false;
+        } catch (const std::exception&) {
+        }
+    };
+
+    Bytes block(8);
+    Bytes truncated = makeKtx2(VK_FORMAT_BC1_RGB_UNORM_BLOCK, 4, 4, {block});
+    truncated.pop_back();
+    expectThrow("Truncated KTX2", truncated);
+
+    Bytes tooManyLevels = makeKtx2(VK_FORMAT_BC1_RGB_UNORM_BLOCK, 4, 4, {block});
+    write<uint32_t>(tooManyLevels, 40, 4);
+    expectThrow("Too many levels", tooManyLevels);
+
+    expectThrow("Unknown DDS format", makeDds("XYZW", 4, 4, block));
+
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+
+    try {
+        passed &= testBc1();
+        passed &= testBc1TransparentBlack();
+        passed &= testBc2();
+        passed &= testBc4And5();
+        passed &= testLevels();
+        passed &= testEtc1();
+        passed &= testEtc2Modes();
+        passed &= testEacAlpha();
+        passed &= testRejected();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        passed = false;
+    }
+
+    std::remove(testPath);
+
+    if (!passed) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All compressed texture blocks decoded as expected" << std::endl;
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 Buffer::Buffer() {}
 
 Buffer::Buffer(VmaAllocator allocator, vk::DeviceSize byteSize, VkBufferUsageFlags usage,
-               bool cpuAccessible)
+               bool cpuAccessible, MemoryBudget* memoryBudget)
     : byteSize(byteSize) {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -17,11 +17,43 @@ Buffer::Buffer(VmaAllocator allocator, vk::DeviceSize byteSize, VkBufferUsageFla
         allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
                                 VMA_ALLOCATION_CREATE_MAPPED_BIT;
     }
+    allocCreateInfo.pUserData =
+        MemoryBudget::tag(memoryBudget, MemoryBudget::categorizeBuffer(usage));
 
     if (byteSize != 0 && vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer,
                                          &allocation, &allocInfo) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create buffer!");
     }
+
+    if (byteSize != 0) {
+        MemoryBudget::track(allocator, allocation);
+    }
+}
+
+Buffer Buffer::fromData(UploadBatch& batch, const void* data, VkDeviceSize byteSize,
+                        VkBufferUsageFlags usage) {
+    Buffer buffer(batch.getAllocator(), byteSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, false,
+                  batch.getMemoryBudget());
+
+    if (byteSize == 0)
+        return buffer;
+
+    StagingAllocation staging = batch.stage(data, byteSize);
+    buffer.copyFromStaging(batch.getCommandBuffer(), staging);
+
+    return buffer;
+}
+
+void Buffer::copyFromStaging(VkCommandBuffer commandBuffer, const StagingAllocation& src,
+                             VkDeviceSize dstOffset) {
+    if (byteSize == 0)
+        return;
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = src.offset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = src.size;
+    vkCmdCopyBuffer(commandBuffer, src.buffer, buffer, 1, &copyRegion);
 }
 
 void Buffer::copyTo(VmaAllocator& allocator, VkQueue graphicsQueue, VkDevice device,
@@ -60,12 +92,50 @@ void Buffer::destroy(VmaAllocator& allocator) {
     if (byteSize == 0)
         return;
 
+    MemoryBudget::untrack(allocator, allocation);
     vmaDestroyBuffer(allocator, buffer, allocation);
 }
 
+void Buffer::retire(VmaAllocator allocator, DeletionQueue& deletionQueue) {
+    if (byteSize == 0)
+        return;
+
+    // Too large for std::function to store inline, buffers are only retired when replaced.
+    deletionQueue.push([allocator, buffer = buffer, allocation = allocation] {
+        MemoryBudget::untrack(allocator, allocation);
+        vmaDestroyBuffer(allocator, buffer, allocation);
+    });
+}
+
 void Buffer::setData(const void* data) {
     if (byteSize == 0)
         return;
 
+    if (allocInfo.pMappedData == nullptr) {
+        throw std::runtime_error("Set the data of a buffer that isn't mapped!");
+    }
+
     memcpy(allocInfo.pMappedData, data, byteSize);
+}
+
+void Buffer::setData(const void* data, VkDeviceSize dataByteSize, VkDeviceSize offset) {
+    if (dataByteSize == 0)
+        return;
+
+    if (offset > byteSize || dataByteSize > byteSize - offset) {
+        throw std::runtime_error("Buffer data is out of the buffer's range!");
+    }
+
+    if (allocInfo.pMappedData == nullptr) {
+        throw std::runtime_error("Set the data of a buffer that isn't mapped!");
+    }
+
+    memcpy(static_cast<char*>(allocInfo.pMappedData) + offset, data, dataByteSize);
+}
+
+void Buffer::flush(VmaAllocator allocator, VkDeviceSize offset, VkDeviceSize size) {
+    if (byteSize == 0)
+        return;
+
+    vmaFlushAllocation(allocator, allocation, offset, size);
 }
\ No newline at end of file
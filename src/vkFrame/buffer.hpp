@@ -6,13 +6,29 @@
 #include <vector>
 
 #include "commands.hpp"
+#include "deletionQueue.hpp"
+#include "memoryBudget.hpp"
 #include "queueFamilyIndices.hpp"
+#include "uploadBatch.hpp"
 
 class Buffer {
 public:
     template <typename T>
     static Buffer fromIndices(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue,
-                              VkDevice device, const std::vector<T>& indices) {
+                              VkDevice device, const std::vector<T>& indices,
+                              MemoryBudget* memoryBudget = nullptr) {
+        UploadBatch batch;
+        batch.begin(allocator, commands, graphicsQueue, device, memoryBudget);
+        Buffer buffer = fromIndices(batch, indices);
+        batch.submit();
+        batch.wait();
+
+        return buffer;
+    }
+
+    // Records the upload into batch, the buffer can't be used until the batch has been submitted.
+    template <typename T>
+    static Buffer fromIndices(UploadBatch& batch, const std::vector<T>& indices) {
         size_t indexSize = sizeof(indices[0]);
 
         // Only accept 16 or 32 bit types.
@@ -23,44 +39,51 @@ public:
 
         VkDeviceSize bufferByteSize = indexSize * indices.size();
 
-        Buffer stagingBuffer(allocator, bufferByteSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, true);
-        stagingBuffer.setData(indices.data());
-
-        Buffer indexBuffer(allocator, bufferByteSize,
-                           VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                           false);
-
-        stagingBuffer.copyTo(allocator, graphicsQueue, device, commands, indexBuffer);
-        stagingBuffer.destroy(allocator);
-
-        return indexBuffer;
+        return fromData(batch, indices.data(), bufferByteSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
     }
 
     template <typename T>
     static Buffer fromVertices(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue,
-                               VkDevice device, const std::vector<T>& vertices) {
-        VkDeviceSize bufferByteSize = sizeof(vertices[0]) * vertices.size();
-
-        Buffer stagingBuffer(allocator, bufferByteSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, true);
-        stagingBuffer.setData(vertices.data());
-
-        Buffer vertexBuffer(allocator, bufferByteSize,
-                            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                            false);
+                               VkDevice device, const std::vector<T>& vertices,
+                               MemoryBudget* memoryBudget = nullptr) {
+        UploadBatch batch;
+        batch.begin(allocator, commands, graphicsQueue, device, memoryBudget);
+        Buffer buffer = fromVertices(batch, vertices);
+        batch.submit();
+        batch.wait();
+
+        return buffer;
+    }
 
-        stagingBuffer.copyTo(allocator, graphicsQueue, device, commands, vertexBuffer);
-        stagingBuffer.destroy(allocator);
+    template <typename T>
+    static Buffer fromVertices(UploadBatch& batch, const std::vector<T>& vertices) {
+        VkDeviceSize bufferByteSize = sizeof(vertices[0]) * vertices.size();
 
-        return vertexBuffer;
+        return fromData(batch, vertices.data(), bufferByteSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
     }
 
+    // Creates a device local buffer holding data, staged and copied by batch.
+    static Buffer fromData(UploadBatch& batch, const void* data, VkDeviceSize byteSize,
+                           VkBufferUsageFlags usage);
+
     Buffer();
+    // The allocation is reported to memoryBudget when there is one.
     Buffer(VmaAllocator allocator, VkDeviceSize byteSize, VkBufferUsageFlags usage,
-           bool cpuAccessible);
+           bool cpuAccessible, MemoryBudget* memoryBudget = nullptr);
     void destroy(VmaAllocator& allocator);
+    // Destroys the buffer once the frames that may still read it have completed.
+    void retire(VmaAllocator allocator, DeletionQueue& deletionQueue);
+    // Copies the whole buffer's worth of bytes, use the overload below for partial data.
     void setData(const void* data);
+    // Copies dataByteSize bytes to offset in the buffer, which must be cpu accessible. Throws if
+    // the bytes don't fit in the buffer.
+    void setData(const void* data, VkDeviceSize dataByteSize, VkDeviceSize offset = 0);
+    // Makes host writes visible to the device, this does nothing for host coherent memory.
+    void flush(VmaAllocator allocator, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
     void copyTo(VmaAllocator& allocator, VkQueue graphicsQueue, VkDevice device, Commands& commands,
                 Buffer& dst);
+    void copyFromStaging(VkCommandBuffer commandBuffer, const StagingAllocation& src,
+                         VkDeviceSize dstOffset = 0);
     const VkBuffer& getBuffer();
     size_t getSize();
     void map(VmaAllocator allocator, void** data);
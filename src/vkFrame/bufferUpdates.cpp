@@ -0,0 +1,106 @@
+#include "bufferUpdates.hpp"
+
+void DirtyRanges::add(VkDeviceSize offset, VkDeviceSize size) {
+    if (size == 0)
+        return;
+
+    ranges.push_back(DirtyRange{offset, size});
+}
+
+const std::vector<DirtyRange>& DirtyRanges::coalesce() {
+    if (ranges.size() < 2)
+        return ranges;
+
+    std::sort(ranges.begin(), ranges.end(),
+              [](const DirtyRange& a, const DirtyRange& b) { return a.offset < b.offset; });
+
+    size_t merged = 0;
+    for (size_t i = 1; i < ranges.size(); i++) {
+        DirtyRange& last = ranges[merged];
+        VkDeviceSize lastEnd = last.offset + last.size;
+
+        if (ranges[i].offset <= lastEnd) {
+            last.size = std::max(lastEnd, ranges[i].offset + ranges[i].size) - last.offset;
+        } else {
+            ranges[++merged] = ranges[i];
+        }
+    }
+
+    ranges.resize(merged + 1);
+    return ranges;
+}
+
+bool DirtyRanges::empty() const { return ranges.empty(); }
+
+void DirtyRanges::clear() { ranges.clear(); }
+
+void BufferUpdates::write(VkDeviceSize dstOffset, const void* data, VkDeviceSize byteSize) {
+    if (byteSize == 0)
+        return;
+
+    size_t dataOffset = this->data.size();
+    this->data.resize(dataOffset + byteSize);
+    memcpy(this->data.data() + dataOffset, data, byteSize);
+
+    writes.push_back(Write{dstOffset, byteSize, dataOffset});
+}
+
+bool BufferUpdates::empty() const { return writes.empty(); }
+
+void BufferUpdates::clear() {
+    writes.clear();
+    data.clear();
+}
+
+void BufferUpdates::record(VkCommandBuffer commandBuffer, StagingRing& stagingRing,
+                           VmaAllocator allocator, VkBuffer dst) {
+    if (writes.empty())
+        return;
+
+    dirtyRanges.clear();
+    for (const Write& write : writes) {
+        dirtyRanges.add(write.dstOffset, write.size);
+    }
+
+    const std::vector<DirtyRange>& ranges = dirtyRanges.coalesce();
+
+    VkDeviceSize stagingSize = 0;
+    for (const DirtyRange& range : ranges) {
+        stagingSize += range.size;
+    }
+
+    StagingAllocation staging = stagingRing.allocate(frameStagingOwner, stagingSize);
+
+    // Each merged range is staged back to back, in the same order as its copy region.
+    regions.clear();
+    VkDeviceSize srcOffset = staging.offset;
+    for (const DirtyRange& range : ranges) {
+        VkBufferCopy region{};
+        region.srcOffset = srcOffset;
+        region.dstOffset = range.offset;
+        region.size = range.size;
+        regions.push_back(region);
+
+        srcOffset += range.size;
+    }
+
+    // Writes are replayed in the order they were made, so later writes overwrite earlier ones.
+    char* stagingData = static_cast<char*>(staging.data);
+    for (const Write& write : writes) {
+        auto range = std::upper_bound(
+            ranges.begin(), ranges.end(), write.dstOffset,
+            [](VkDeviceSize offset, const DirtyRange& range) { return offset < range.offset; });
+        const VkBufferCopy& region = regions[std::distance(ranges.begin(), range) - 1];
+
+        VkDeviceSize stagingOffset = region.srcOffset - staging.offset;
+        memcpy(stagingData + stagingOffset + write.dstOffset - region.dstOffset,
+               data.data() + write.dataOffset, write.size);
+    }
+
+    stagingRing.flush(allocator, staging);
+
+    vkCmdCopyBuffer(commandBuffer, staging.buffer, dst, static_cast<uint32_t>(regions.size()),
+                    regions.data());
+
+    clear();
+}
\ No newline at end of file
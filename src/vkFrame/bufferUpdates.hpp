@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "stagingRing.hpp"
+
+struct DirtyRange {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+// Byte ranges of a buffer that have changed, merged into as few ranges as possible.
+class DirtyRanges {
+public:
+    void add(VkDeviceSize offset, VkDeviceSize size);
+    // Sorts the ranges by offset and merges any that overlap or touch.
+    const std::vector<DirtyRange>& coalesce();
+    bool empty() const;
+    void clear();
+
+private:
+    std::vector<DirtyRange> ranges;
+};
+
+/*
+ * Collects partial writes to a device local buffer and uploads only the bytes that changed.
+ * Writes are coalesced into the fewest copy regions, staged through the staging ring and recorded
+ * as a single copy. Where writes overlap, the one made last wins.
+ */
+class BufferUpdates {
+public:
+    // The data is copied straight away, so the caller's memory can be reused.
+    void write(VkDeviceSize dstOffset, const void* data, VkDeviceSize byteSize);
+    bool empty() const;
+    // Drops writes that haven't been recorded yet.
+    void clear();
+
+    // Must be recorded outside a render pass into the frame's command buffer, its staging belongs
+    // to frameStagingOwner, which the renderer submits with every frame.
+    void record(VkCommandBuffer commandBuffer, StagingRing& stagingRing, VmaAllocator allocator,
+                VkBuffer dst);
+
+private:
+    struct Write {
+        VkDeviceSize dstOffset;
+        VkDeviceSize size;
+        size_t dataOffset;
+    };
+
+    // Kept between frames so recording doesn't allocate once they have grown.
+    std::vector<Write> writes;
+    std::vector<char> data;
+    DirtyRanges dirtyRanges;
+    std::vector<VkBufferCopy> regions;
+};
\ No newline at end of file
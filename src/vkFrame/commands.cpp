@@ -1,6 +1,8 @@
 #include "commands.hpp"
 
 VkCommandBuffer Commands::beginSingleTime(VkQueue graphicsQueue, VkDevice device) {
+    freeCompleted(device);
+
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -21,23 +23,53 @@ VkCommandBuffer Commands::beginSingleTime(VkQueue graphicsQueue, VkDevice device
 
 void Commands::endSingleTime(VkCommandBuffer commandBuffer, VkQueue graphicsQueue,
                              VkDevice device) {
+    uint64_t value = submitSingleTime(commandBuffer, graphicsQueue);
+
+    // Only waits for this submission rather than everything else queued before it.
+    timeline.wait(value);
+
+    freeCompleted(device);
+}
+
+uint64_t Commands::submitSingleTime(VkCommandBuffer commandBuffer, VkQueue graphicsQueue) {
     vkEndCommandBuffer(commandBuffer);
 
+    uint64_t value = timeline.nextValue();
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline.getSemaphore();
+
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit single time command buffer!");
+    }
+
+    pendingBuffers.push_back(PendingBuffer{commandBuffer, value});
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    return value;
+}
 
+void Commands::freeSingleTime(VkCommandBuffer commandBuffer, VkDevice device) {
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
 
-void Commands::createPool(VkPhysicalDevice physicalDevice, VkDevice device, VkSurfaceKHR surface) {
-    QueueFamilyIndices queueFamilyIndices =
-        QueueFamilyIndices::findQueueFamilies(physicalDevice, surface);
+void Commands::freeCompleted(VkDevice device) {
+    while (!pendingBuffers.empty() && timeline.isComplete(pendingBuffers.front().timelineValue)) {
+        vkFreeCommandBuffers(device, commandPool, 1, &pendingBuffers.front().commandBuffer);
+        pendingBuffers.pop_front();
+    }
+}
 
+void Commands::createPool(VkDevice device, const QueueFamilyIndices& queueFamilyIndices) {
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
@@ -48,6 +80,16 @@ void Commands::createPool(VkPhysicalDevice physicalDevice, VkDevice device, VkSu
     }
 }
 
+void Commands::createTimelines(VkDevice device) {
+    timeline.create(device);
+    frameTimeline.create(device);
+}
+
+void Commands::destroyTimelines(VkDevice device) {
+    timeline.destroy(device);
+    frameTimeline.destroy(device);
+}
+
 void Commands::createBuffers(VkDevice device, size_t maxFramesInFlight) {
     buffers.resize(maxFramesInFlight);
 
@@ -85,4 +127,14 @@ const VkCommandBuffer& Commands::getBuffer(const uint32_t currentFrame) {
     return buffers[currentFrame];
 }
 
-void Commands::destroy(VkDevice device) { vkDestroyCommandPool(device, commandPool, nullptr); }
\ No newline at end of file
+Timeline& Commands::getTimeline() { return timeline; }
+
+Timeline& Commands::getFrameTimeline() { return frameTimeline; }
+
+StagingRing& Commands::getStagingRing() { return stagingRing; }
+
+void Commands::destroy(VkDevice device) {
+    // Destroying the pool frees every buffer still pending.
+    pendingBuffers.clear();
+    vkDestroyCommandPool(device, commandPool, nullptr);
+}
\ No newline at end of file
@@ -2,16 +2,27 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <deque>
 #include <vector>
 
 #include "queueFamilyIndices.hpp"
+#include "stagingRing.hpp"
+#include "timeline.hpp"
 
 class Commands {
 public:
     VkCommandBuffer beginSingleTime(VkQueue graphicsQueue, VkDevice device);
     void endSingleTime(VkCommandBuffer commandBuffer, VkQueue graphicsQueue, VkDevice device);
+    // Submits a buffer from beginSingleTime without waiting for it and returns the timeline value
+    // it signals, the buffer is freed once that value has completed.
+    uint64_t submitSingleTime(VkCommandBuffer commandBuffer, VkQueue graphicsQueue);
+    // Frees a buffer from beginSingleTime that won't be submitted after all.
+    void freeSingleTime(VkCommandBuffer commandBuffer, VkDevice device);
 
-    void createPool(VkPhysicalDevice physicalDevice, VkDevice device, VkSurfaceKHR surface);
+    void createPool(VkDevice device, const QueueFamilyIndices& queueFamilyIndices);
+    // The renderer creates the timelines with its other sync objects, apps only create the pool.
+    void createTimelines(VkDevice device);
+    void destroyTimelines(VkDevice device);
 
     void createBuffers(VkDevice device, size_t maxFramesInFlight);
     void resetBuffer(const uint32_t imageIndex, const uint32_t currentFrame);
@@ -19,9 +30,28 @@ public:
     void endBuffer(const uint32_t currentFrame);
     const VkCommandBuffer& getBuffer(const uint32_t currentFrame);
 
+    // Every submission to the graphics queue signals the next value of this timeline.
+    Timeline& getTimeline();
+    // Only frame submissions signal this one, each frame reserves its value when it is acquired.
+    Timeline& getFrameTimeline();
+    // Uploads are staged through this, whoever submits the commands that read a region submits
+    // it to the ring too.
+    StagingRing& getStagingRing();
+
     void destroy(VkDevice device);
 
 private:
+    struct PendingBuffer {
+        VkCommandBuffer commandBuffer;
+        uint64_t timelineValue;
+    };
+
+    void freeCompleted(VkDevice device);
+
     VkCommandPool commandPool;
     std::vector<VkCommandBuffer> buffers;
+    std::deque<PendingBuffer> pendingBuffers;
+    Timeline timeline;
+    Timeline frameTimeline;
+    StagingRing stagingRing;
 };
\ No newline at end of file
@@ -0,0 +1,752 @@
+#include "compressedTexture.hpp"
+
+namespace {
+
+const uint8_t ktx2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                    0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+template <typename T> T read(const std::vector<uint8_t>& file, size_t offset) {
+    if (offset + sizeof(T) > file.size()) {
+        throw std::runtime_error("Compressed texture file is truncated!");
+    }
+
+    T value;
+    memcpy(&value, file.data() + offset, sizeof(T));
+    return value;
+}
+
+uint32_t fourCC(const char* code) {
+    return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 |
+           static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+}
+
+uint8_t clampByte(int32_t value) {
+    return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+// Texels of a decoded 4x4 block, row by row.
+using Block = uint8_t[16][4];
+
+// BC1 blocks switch to three colors and black when color0 <= color1, black is transparent if
+// the format has alpha. BC2 and BC3 color blocks always have four colors.
+void decodeColorBlock(const uint8_t* block, Block& texels, bool bc1, bool transparentBlack) {
+    uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+    uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+    uint32_t indices = 0;
+    for (int32_t i = 0; i < 4; i++) {
+        indices |= static_cast<uint32_t>(block[4 + i]) << (8 * i);
+    }
+
+    int32_t palette[4][4];
+    uint16_t colors[2] = {color0, color1};
+    for (int32_t i = 0; i < 2; i++) {
+        int32_t r = colors[i] >> 11 & 31;
+        int32_t g = colors[i] >> 5 & 63;
+        int32_t b = colors[i] & 31;
+        palette[i][0] = r << 3 | r >> 2;
+        palette[i][1] = g << 2 | g >> 4;
+        palette[i][2] = b << 3 | b >> 2;
+        palette[i][3] = 255;
+    }
+
+    bool fourColors = !bc1 || color0 > color1;
+    for (int32_t c = 0; c < 3; c++) {
+        if (fourColors) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = fourColors || !transparentBlack ? 255 : 0;
+
+    for (int32_t i = 0; i < 16; i++) {
+        const int32_t* color = palette[indices >> (2 * i) & 3];
+        for (int32_t c = 0; c < 4; c++) {
+            texels[i][c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+}
+
+// The alpha block of BC3, also every channel of BC4 and BC5.
+void decodeChannelBlock(const uint8_t* block, Block& texels, int32_t channel) {
+    int32_t values[8];
+    values[0] = block[0];
+    values[1] = block[1];
+
+    if (values[0] > values[1]) {
+        for (int32_t i = 1; i < 7; i++) {
+            values[i + 1] = ((7 - i) * values[0] + i * values[1]) / 7;
+        }
+    } else {
+        for (int32_t i = 1; i < 5; i++) {
+            values[i + 1] = ((5 - i) * values[0] + i * values[1]) / 5;
+        }
+        values[6] = 0;
+        values[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int32_t i = 0; i < 6; i++) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+
+    for (int32_t i = 0; i < 16; i++) {
+        texels[i][channel] = static_cast<uint8_t>(values[indices >> (3 * i) & 7]);
+    }
+}
+
+uint64_t readBigEndian(const uint8_t* block) {
+    uint64_t value = 0;
+    for (int32_t i = 0; i < 8; i++) {
+        value = value << 8 | block[i];
+    }
+
+    return value;
+}
+
+int32_t extend4(uint32_t value) { return static_cast<int32_t>(value << 4 | value); }
+
+int32_t extend5(uint32_t value) { return static_cast<int32_t>(value << 3 | value >> 2); }
+
+int32_t extend6(uint32_t value) { return static_cast<int32_t>(value << 2 | value >> 4); }
+
+int32_t extend7(uint32_t value) { return static_cast<int32_t>(value << 1 | value >> 6); }
+
+// ETC2 RGB, which includes ETC1. ETC pixel indices run column by column.
+void decodeEtc2Block(const uint8_t* block, Block& texels) {
+    static const int32_t modifiers[8][2] = {{2, 8},   {5, 17},  {9, 29},   {13, 42},
+                                            {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+    static const int32_t distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+    uint64_t bits = readBigEndian(block);
+    bool differential = bits >> 33 & 1;
+    bool flip = bits >> 32 & 1;
+
+    auto pixelIndex = [&](int32_t x, int32_t y) {
+        int32_t k = x * 4 + y;
+        return static_cast<int32_t>((bits >> (k + 16) & 1) << 1 | (bits >> k & 1));
+    };
+
+    auto setTexel = [&](int32_t x, int32_t y, int32_t r, int32_t g, int32_t b) {
+        uint8_t* texel = texels[y * 4 + x];
+        texel[0] = clampByte(r);
+        texel[1] = clampByte(g);
+        texel[2] = clampByte(b);
+        texel[3] = 255;
+    };
+
+    int32_t base[2][3];
+
+    if (!differential) {
+        for (int32_t c = 0; c < 3; c++) {
+            base[0][c] = extend4(bits >> (60 - 8 * c) & 15);
+            base[1][c] = extend4(bits >> (56 - 8 * c) & 15);
+        }
+    } else {
+        int32_t first[3];
+        int32_t second[3];
+        for (int32_t c = 0; c < 3; c++) {
+            first[c] = static_cast<int32_t>(bits >> (59 - 8 * c) & 31);
+            int32_t delta = static_cast<int32_t>(bits >> (56 - 8 * c) & 7);
+            second[c] = first[c] + (delta >= 4 ? delta - 8 : delta);
+        }
+
+        // An overflowing channel selects one of the modes ETC2 added.
+        if (second[0] < 0 || second[0] > 31) {
+            // T mode.
+            int32_t color0[3] = {extend4((bits >> 59 & 3) << 2 | (bits >> 56 & 3)),
+                                 extend4(bits >> 52 & 15), extend4(bits >> 48 & 15)};
+            int32_t color1[3] = {extend4(bits >> 44 & 15), extend4(bits >> 40 & 15),
+                                 extend4(bits >> 36 & 15)};
+            int32_t distance = distances[(bits >> 34 & 3) << 1 | (bits >> 32 & 1)];
+
+            int32_t paint[4][3];
+            for (int32_t c = 0; c < 3; c++) {
+                paint[0][c] = color0[c];
+                paint[1][c] = color1[c] + distance;
+                paint[2][c] = color1[c];
+                paint[3][c] = color1[c] - distance;
+            }
+
+            for (int32_t x = 0; x < 4; x++) {
+                for (int32_t y = 0; y < 4; y++) {
+                    const int32_t* color = paint[pixelIndex(x, y)];
+                    setTexel(x, y, color[0], color[1], color[2]);
+                }
+            }
+            return;
+        }
+
+        if (second[1] < 0 || second[1] > 31) {
+            // H mode.
+            uint32_t r0 = bits >> 59 & 15;
+            uint32_t g0 = (bits >> 56 & 7) << 1 | (bits >> 52 & 1);
+            uint32_t b0 = (bits >> 51 & 1) << 3 | (bits >> 47 & 7);
+            uint32_t r1 = bits >> 43 & 15;
+            uint32_t g1 = bits >> 39 & 15;
+            uint32_t b1 = bits >> 35 & 15;
+
+            uint32_t order = (r0 << 8 | g0 << 4 | b0) >= (r1 << 8 | g1 << 4 | b1) ? 1 : 0;
+            int32_t distance = distances[(bits >> 34 & 1) << 2 | (bits >> 32 & 1) << 1 | order];
+
+            int32_t color0[3] = {extend4(r0), extend4(g0), extend4(b0)};
+            int32_t color1[3] = {extend4(r1), extend4(g1), extend4(b1)};
+
+            int32_t paint[4][3];
+            for (int32_t c = 0; c < 3; c++) {
+                paint[0][c] = color0[c] + distance;
+                paint[1][c] = color0[c] - distance;
+                paint[2][c] = color1[c] + distance;
+                paint[3][c] = color1[c] - distance;
+            }
+
+            for (int32_t x = 0; x < 4; x++) {
+                for (int32_t y = 0; y < 4; y++) {
+                    const int32_t* color = paint[pixelIndex(x, y)];
+                    setTexel(x, y, color[0], color[1], color[2]);
+                }
+            }
+            return;
+        }
+
+        if (second[2] < 0 || second[2] > 31) {
+            // Planar mode, a gradient across the block.
+            int32_t origin[3] = {
+                extend6(bits >> 57 & 63), extend7((bits >> 56 & 1) << 6 | (bits >> 49 & 63)),
+                extend6((bits >> 48 & 1) << 5 | (bits >> 43 & 3) << 3 | (bits >> 39 & 7))};
+            int32_t horizontal[3] = {extend6((bits >> 34 & 31) << 1 | (bits >> 32 & 1)),
+                                     extend7(bits >> 25 & 127), extend6(bits >> 19 & 63)};
+            int32_t vertical[3] = {extend6(bits >> 13 & 63), extend7(bits >> 6 & 127),
+                                   extend6(bits & 63)};
+
+            for (int32_t x = 0; x < 4; x++) {
+                for (int32_t y = 0; y < 4; y++) {
+                    int32_t color[3];
+                    for (int32_t c = 0; c < 3; c++) {
+                        color[c] = (x * (horizontal[c] - origin[c]) +
+                                    y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >>
+                                   2;
+                    }
+                    setTexel(x, y, color[0], color[1], color[2]);
+                }
+            }
+            return;
+        }
+
+        for (int32_t c = 0; c < 3; c++) {
+            base[0][c] = extend5(first[c]);
+            base[1][c] = extend5(second[c]);
+        }
+    }
+
+    int32_t tables[2] = {static_cast<int32_t>(bits >> 37 & 7),
+                         static_cast<int32_t>(bits >> 34 & 7)};
+
+    for (int32_t x = 0; x < 4; x++) {
+        for (int32_t y = 0; y < 4; y++) {
+            int32_t subblock = flip ? (y >= 2) : (x >= 2);
+            int32_t index = pixelIndex(x, y);
+            int32_t modifier = modifiers[tables[subblock]][index & 1];
+            if (index & 2) {
+                modifier = -modifier;
+            }
+
+            const int32_t* color = base[subblock];
+            setTexel(x, y, color[0] + modifier, color[1] + modifier, color[2] + modifier);
+        }
+    }
+}
+
+// The alpha block of ETC2 RGBA8.
+void decodeEacAlphaBlock(const uint8_t* block, Block& texels) {
+    static const int32_t modifiers[16][8] = {
+        {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+    uint64_t bits = readBigEndian(block);
+    int32_t base = static_cast<int32_t>(bits >> 56 & 255);
+    int32_t multiplier = static_cast<int32_t>(bits >> 52 & 15);
+    const int32_t* table = modifiers[bits >> 48 & 15];
+
+    for (int32_t x = 0; x < 4; x++) {
+        for (int32_t y = 0; y < 4; y++) {
+            int32_t k = x * 4 + y;
+            int32_t index = static_cast<int32_t>(bits >> (45 - 3 * k) & 7);
+            texels[y * 4 + x][3] = clampByte(base + table[index] * multiplier);
+        }
+    }
+}
+
+bool isSrgb(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        return true;
+    default:
+        // ASTC alternates between UNORM and SRGB, starting with UNORM.
+        return format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK &&
+               format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK &&
+               (format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) % 2 == 1;
+    }
+}
+
+void decodeBlock(VkFormat format, const uint8_t* block, Block& texels) {
+    switch (format) {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        decodeColorBlock(block, texels, true, false);
+        break;
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        decodeColorBlock(block, texels, true, true);
+        break;
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+        decodeColorBlock(block + 8, texels, false, false);
+        for (int32_t i = 0; i < 16; i++) {
+            uint8_t alpha = block[i / 2] >> (4 * (i % 2)) & 15;
+            texels[i][3] = static_cast<uint8_t>(alpha << 4 | alpha);
+        }
+        break;
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+        decodeColorBlock(block + 8, texels, false, false);
+        decodeChannelBlock(block, texels, 3);
+        break;
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+        memset(texels, 0, sizeof(Block));
+        decodeChannelBlock(block, texels, 0);
+        for (int32_t i = 0; i < 16; i++) {
+            texels[i][3] = 255;
+        }
+        break;
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+        memset(texels, 0, sizeof(Block));
+        decodeChannelBlock(block, texels, 0);
+        decodeChannelBlock(block + 8, texels, 1);
+        for (int32_t i = 0; i < 16; i++) {
+            texels[i][3] = 255;
+        }
+        break;
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        decodeEtc2Block(block, texels);
+        break;
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        decodeEtc2Block(block + 8, texels);
+        decodeEacAlphaBlock(block, texels);
+        break;
+    default:
+        throw std::runtime_error("Compressed texture format can't be transcoded!");
+    }
+}
+
+} // namespace
+
+CompressedTexture CompressedTexture::fromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open compressed texture!");
+    }
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> contents(fileSize);
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(contents.data()), fileSize);
+    file.close();
+
+    if (fileSize >= sizeof(ktx2Identifier) &&
+        memcmp(contents.data(), ktx2Identifier, sizeof(ktx2Identifier)) == 0) {
+        return fromKtx2(contents);
+    }
+
+    if (fileSize >= 4 && read<uint32_t>(contents, 0) == fourCC("DDS ")) {
+        return fromDds(contents);
+    }
+
+    throw std::runtime_error("Compressed texture isn't a KTX2 or DDS file!");
+}
+
+CompressedTexture CompressedTexture::fromKtx2(const std::vector<uint8_t>& file) {
+    CompressedTexture texture;
+    texture.format = static_cast<VkFormat>(read<uint32_t>(file, 12));
+    texture.width = read<uint32_t>(file, 20);
+    texture.height = read<uint32_t>(file, 24);
+    uint32_t depth = read<uint32_t>(file, 28);
+    texture.layerCount = std::max(read<uint32_t>(file, 32), 1u);
+    uint32_t faceCount = read<uint32_t>(file, 36);
+    // Zero asks the loader to generate mips, only the base level is stored.
+    uint32_t levelCount = std::max(read<uint32_t>(file, 40), 1u);
+    uint32_t supercompressionScheme = read<uint32_t>(file, 44);
+
+    // Basis Universal textures have no Vulkan format and are always supercompressed.
+    if (supercompressionScheme != 0 || texture.format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("Supercompressed KTX2 textures aren't supported!");
+    }
+
+    if (depth > 1 || faceCount != 1) {
+        throw std::runtime_error("Only 2D textures and texture arrays can be loaded!");
+    }
+
+    texture.layoutLevels(levelCount, file.size());
+
+    // The level index follows the 80 byte header, and starts with the base level.
+    for (uint32_t i = 0; i < levelCount; i++) {
+        size_t entry = 80 + i * 24;
+        uint64_t byteOffset = read<uint64_t>(file, entry);
+        uint64_t byteLength = read<uint64_t>(file, entry + 8);
+
+        const TextureLevel& level = texture.levels[i];
+        // byteLength is known to fit in the file, so subtracting it can't wrap around.
+        if (byteLength != level.byteSize || byteOffset > file.size() - byteLength) {
+            throw std::runtime_error("Compressed texture file is truncated!");
+        }
+
+        memcpy(texture.data.data() + level.offset, file.data() + byteOffset, level.byteSize);
+    }
+
+    return texture;
+}
+
+CompressedTexture CompressedTexture::fromDds(const std::vector<uint8_t>& file) {
+    const uint32_t ddpfFourCC = 0x4;
+    const uint32_t ddpfRgb = 0x40;
+    const uint32_t caps2Cubemap = 0x200;
+    const uint32_t caps2Volume = 0x200000;
+
+    CompressedTexture texture;
+    texture.height = read<uint32_t>(file, 12);
+    texture.width = read<uint32_t>(file, 16);
+    uint32_t levelCount = std::max(read<uint32_t>(file, 28), 1u);
+    uint32_t pixelFormatFlags = read<uint32_t>(file, 80);
+    uint32_t pixelFourCC = read<uint32_t>(file, 84);
+    uint32_t caps2 = read<uint32_t>(file, 112);
+
+    if (caps2 & (caps2Cubemap | caps2Volume)) {
+        throw std::runtime_error("Only 2D textures and texture arrays can be loaded!");
+    }
+
+    size_t dataOffset = 128;
+
+    if ((pixelFormatFlags & ddpfFourCC) && pixelFourCC == fourCC("DX10")) {
+        uint32_t dxgiFormat = read<uint32_t>(file, 128);
+        uint32_t resourceDimension = read<uint32_t>(file, 132);
+        uint32_t miscFlag = read<uint32_t>(file, 136);
+        texture.layerCount = std::max(read<uint32_t>(file, 140), 1u);
+        dataOffset = 148;
+
+        // Anything but a 2D texture, or a cube map.
+        if (resourceDimension != 3 || (miscFlag & 0x4)) {
+            throw std::runtime_error("Only 2D textures and texture arrays can be loaded!");
+        }
+
+        switch (dxgiFormat) {
+        case 28:
+            texture.format = VK_FORMAT_R8G8B8A8_UNORM;
+            break;
+        case 29:
+            texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+            break;
+        case 71:
+            texture.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            break;
+        case 72:
+            texture.format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            break;
+        case 74:
+            texture.format = VK_FORMAT_BC2_UNORM_BLOCK;
+            break;
+        case 75:
+            texture.format = VK_FORMAT_BC2_SRGB_BLOCK;
+            break;
+        case 77:
+            texture.format = VK_FORMAT_BC3_UNORM_BLOCK;
+            break;
+        case 78:
+            texture.format = VK_FORMAT_BC3_SRGB_BLOCK;
+            break;
+        case 80:
+            texture.format = VK_FORMAT_BC4_UNORM_BLOCK;
+            break;
+        case 81:
+            texture.format = VK_FORMAT_BC4_SNORM_BLOCK;
+            break;
+        case 83:
+            texture.format = VK_FORMAT_BC5_UNORM_BLOCK;
+            break;
+        case 84:
+            texture.format = VK_FORMAT_BC5_SNORM_BLOCK;
+            break;
+        case 95:
+            texture.format = VK_FORMAT_BC6H_UFLOAT_BLOCK;
+            break;
+        case 96:
+            texture.format = VK_FORMAT_BC6H_SFLOAT_BLOCK;
+            break;
+        case 98:
+            texture.format = VK_FORMAT_BC7_UNORM_BLOCK;
+            break;
+        case 99:
+            texture.format = VK_FORMAT_BC7_SRGB_BLOCK;
+            break;
+        default:
+            throw std::runtime_error("Unsupported compressed texture format!");
+        }
+    } else if (pixelFormatFlags & ddpfFourCC) {
+        if (pixelFourCC == fourCC("DXT1")) {
+            texture.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        } else if (pixelFourCC == fourCC("DXT2") || pixelFourCC == fourCC("DXT3")) {
+            texture.format = VK_FORMAT_BC2_UNORM_BLOCK;
+        } else if (pixelFourCC == fourCC("DXT4") || pixelFourCC == fourCC("DXT5")) {
+            texture.format = VK_FORMAT_BC3_UNORM_BLOCK;
+        } else if (pixelFourCC == fourCC("ATI1") || pixelFourCC == fourCC("BC4U")) {
+            texture.format = VK_FORMAT_BC4_UNORM_BLOCK;
+        } else if (pixelFourCC == fourCC("ATI2") || pixelFourCC == fourCC("BC5U")) {
+            texture.format = VK_FORMAT_BC5_UNORM_BLOCK;
+        } else {
+            throw std::runtime_error("Unsupported compressed texture format!");
+        }
+    } else if ((pixelFormatFlags & ddpfRgb) && read<uint32_t>(file, 88) == 32 &&
+               read<uint32_t>(file, 92) == 0x000000FF && read<uint32_t>(file, 96) == 0x0000FF00 &&
+               read<uint32_t>(file, 100) == 0x00FF0000) {
+        texture.format = VK_FORMAT_R8G8B8A8_UNORM;
+    } else {
+        throw std::runtime_error("Unsupported compressed texture format!");
+    }
+
+    texture.layoutLevels(levelCount, file.size());
+
+    // DDS stores each layer's whole mip chain in turn, the levels here hold every layer in turn.
+    size_t fileOffset = dataOffset;
+    for (uint32_t layer = 0; layer < texture.layerCount; layer++) {
+        for (const TextureLevel& level : texture.levels) {
+            size_t layerByteSize = level.byteSize / texture.layerCount;
+            if (fileOffset + layerByteSize > file.size()) {
+                throw std::runtime_error("Compressed texture file is truncated!");
+            }
+
+            memcpy(texture.data.data() + level.offset + layer * layerByteSize,
+                   file.data() + fileOffset, layerByteSize);
+            fileOffset += layerByteSize;
+        }
+    }
+
+    return texture;
+}
+
+bool CompressedTexture::getBlockInfo(VkFormat format, uint32_t& blockWidth,
+                                     uint32_t& blockHeight, uint32_t& blockByteSize) {
+    blockWidth = 4;
+    blockHeight = 4;
+
+    switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+        blockWidth = 1;
+        blockHeight = 1;
+        blockByteSize = 4;
+        return true;
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+    case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+    case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+        blockByteSize = 8;
+        return true;
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+    case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+    case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+        blockByteSize = 16;
+        return true;
+    default:
+        break;
+    }
+
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        // Every ASTC block is 16 bytes, the formats come in UNORM and SRGB pairs.
+        static const uint32_t astcBlocks[14][2] = {{4, 4},  {5, 4},  {5, 5},   {6, 5},  {6, 6},
+                                                   {8, 5},  {8, 6},  {8, 8},   {10, 5}, {10, 6},
+                                                   {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+        const uint32_t* block = astcBlocks[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+        blockWidth = block[0];
+        blockHeight = block[1];
+        blockByteSize = 16;
+        return true;
+    }
+
+    return false;
+}
+
+bool CompressedTexture::isSupported(VkPhysicalDevice physicalDevice, VkFormat format) {
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+
+    VkFormatFeatureFlags required =
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+bool CompressedTexture::canTranscode() const {
+    switch (format) {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void CompressedTexture::transcode() {
+    if (!canTranscode()) {
+        throw std::runtime_error("Compressed texture format can't be transcoded!");
+    }
+
+    uint32_t blockWidth, blockHeight, blockByteSize;
+    getBlockInfo(format, blockWidth, blockHeight, blockByteSize);
+
+    VkFormat compressedFormat = format;
+    std::vector<TextureLevel> compressedLevels = levels;
+    std::vector<uint8_t> compressedData;
+    compressedData.swap(data);
+
+    format = isSrgb(compressedFormat) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    // Every block decodes to at most 4x4 RGBA8 texels.
+    layoutLevels(static_cast<uint32_t>(compressedLevels.size()),
+                 compressedData.size() / blockByteSize * 64);
+
+    Block texels;
+    for (size_t i = 0; i < levels.size(); i++) {
+        const TextureLevel& level = levels[i];
+        const uint8_t* source = compressedData.data() + compressedLevels[i].offset;
+        uint32_t blocksX = (level.width + 3) / 4;
+        uint32_t blocksY = (level.height + 3) / 4;
+
+        for (uint32_t layer = 0; layer < layerCount; layer++) {
+            uint8_t* layerTexels =
+                data.data() + level.offset + static_cast<size_t>(layer) * level.width *
+                                                 level.height * 4;
+
+            for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+                for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                    decodeBlock(compressedFormat, source, texels);
+                    source += blockByteSize;
+
+                    // Blocks overhanging the edge of small levels are clipped.
+                    for (uint32_t y = 0; y < 4 && blockY * 4 + y < level.height; y++) {
+                        for (uint32_t x = 0; x < 4 && blockX * 4 + x < level.width; x++) {
+                            size_t texel = (blockY * 4 + y) * level.width + blockX * 4 + x;
+                            memcpy(layerTexels + texel * 4, texels[y * 4 + x], 4);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+VkFormat CompressedTexture::getFormat() const { return format; }
+
+uint32_t CompressedTexture::getWidth() const { return width; }
+
+uint32_t CompressedTexture::getHeight() const { return height; }
+
+uint32_t CompressedTexture::getLayerCount() const { return layerCount; }
+
+const std::vector<TextureLevel>& CompressedTexture::getLevels() const { return levels; }
+
+const std::vector<uint8_t>& CompressedTexture::getData() const { return data; }
+
+void CompressedTexture::layoutLevels(uint32_t levelCount, size_t maxByteSize) {
+    uint32_t blockWidth, blockHeight, blockByteSize;
+    if (!getBlockInfo(format, blockWidth, blockHeight, blockByteSize)) {
+        throw std::runtime_error("Unsupported compressed texture format!");
+    }
+
+    // The chain ends at 1x1, floor(log2(max(width, height))) + 1 levels, and shifting the size by
+    // 32 or more would be undefined.
+    uint32_t maxLevelCount = 1;
+    uint32_t size = std::max(width, height);
+    while (maxLevelCount < 32 && (size >> maxLevelCount) != 0) {
+        maxLevelCount++;
+    }
+
+    if (width == 0 || height == 0 || levelCount > maxLevelCount) {
+        throw std::runtime_error("Unsupported compressed texture format!");
+    }
+
+    levels.resize(levelCount);
+
+    // Loaded levels are read from the file, so they can't be larger than it. Bounding the total
+    // also keeps the sizes from overflowing.
+    size_t offset = 0;
+    for (uint32_t i = 0; i < levelCount; i++) {
+        TextureLevel& level = levels[i];
+        level.width = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+
+        size_t blocks = ((static_cast<size_t>(level.width) + blockWidth - 1) / blockWidth) *
+                        ((static_cast<size_t>(level.height) + blockHeight - 1) / blockHeight);
+        if (blocks > maxByteSize / blockByteSize / layerCount) {
+            throw std::runtime_error("Compressed texture file is truncated!");
+        }
+
+        level.offset = offset;
+        level.byteSize = blocks * blockByteSize * layerCount;
+        if (level.byteSize > maxByteSize - offset) {
+            throw std::runtime_error("Compressed texture file is truncated!");
+        }
+
+        offset += level.byteSize;
+    }
+
+    data.resize(offset);
+}
\ No newline at end of file
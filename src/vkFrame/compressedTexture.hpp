@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct TextureLevel {
+    // Where the level starts in the texture's data, its layers follow each other.
+    size_t offset = 0;
+    size_t byteSize = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+/*
+ * The contents of a KTX2 or DDS file: a 2D texture or texture array in a block-compressed (or
+ * plain RGBA8) format, with every mip level it was saved with. Supercompressed KTX2 files, cube
+ * maps and volume textures aren't supported.
+ */
+class CompressedTexture {
+public:
+    // Picks the container from the file's magic number.
+    static CompressedTexture fromFile(const std::string& path);
+
+    // Texel block dimensions and byte size, false for formats this can't load.
+    static bool getBlockInfo(VkFormat format, uint32_t& blockWidth, uint32_t& blockHeight,
+                             uint32_t& blockByteSize);
+    // Whether the optimal tiling features of format on physicalDevice allow sampling.
+    static bool isSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+
+    // Whether transcode can decompress this texture's format.
+    bool canTranscode() const;
+    // Decompresses every level to RGBA8, keeping the layout of the levels and layers. The
+    // format becomes R8G8B8A8 with the same color space, BC4 and BC5 fill the missing channels
+    // with 0 and alpha with 255.
+    void transcode();
+
+    VkFormat getFormat() const;
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getLayerCount() const;
+    const std::vector<TextureLevel>& getLevels() const;
+    const std::vector<uint8_t>& getData() const;
+
+private:
+    static CompressedTexture fromKtx2(const std::vector<uint8_t>& file);
+    static CompressedTexture fromDds(const std::vector<uint8_t>& file);
+
+    // Fills in every level's size and offset for levels stored back to back. Throws if the header
+    // describes more levels than the size allows, or levels larger than maxByteSize in total.
+    void layoutLevels(uint32_t levelCount, size_t maxByteSize);
+
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t layerCount = 1;
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+};
\ No newline at end of file
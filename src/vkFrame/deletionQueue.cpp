@@ -0,0 +1,48 @@
+#include "deletionQueue.hpp"
+
+void DeletionQueue::create(Timeline& timeline, Timeline& frameTimeline) {
+    this->timeline = &timeline;
+    this->frameTimeline = &frameTimeline;
+}
+
+void DeletionQueue::push(std::function<void()> deleter) {
+    // Other submissions only read resources that exist when they are submitted, but the frame
+    // being recorded may already reference it.
+    uint64_t timelineValue = timeline != nullptr ? timeline->getLastSubmittedValue() : 0;
+    uint64_t frameValue = frameTimeline != nullptr ? frameTimeline->getReservedValue() : 0;
+    entries.push_back(Entry{timelineValue, frameValue, std::move(deleter)});
+}
+
+void DeletionQueue::retireImageView(VkDevice device, VkImageView imageView) {
+    push([device, imageView] { vkDestroyImageView(device, imageView, nullptr); });
+}
+
+void DeletionQueue::retireSampler(VkDevice device, VkSampler sampler) {
+    push([device, sampler] { vkDestroySampler(device, sampler, nullptr); });
+}
+
+void DeletionQueue::collect() {
+    if (entries.empty() || timeline == nullptr)
+        return;
+
+    // Values only ever increase, so entries are already in completion order.
+    uint64_t completedValue = timeline->getCompletedValue();
+    uint64_t completedFrameValue = frameTimeline->getCompletedValue();
+    size_t completedCount = 0;
+    while (completedCount < entries.size() &&
+           entries[completedCount].timelineValue <= completedValue &&
+           entries[completedCount].frameValue <= completedFrameValue) {
+        entries[completedCount].deleter();
+        completedCount++;
+    }
+
+    entries.erase(entries.begin(), entries.begin() + completedCount);
+}
+
+void DeletionQueue::flush() {
+    for (Entry& entry : entries) {
+        entry.deleter();
+    }
+
+    entries.clear();
+}
\ No newline at end of file
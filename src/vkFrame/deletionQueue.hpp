@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "timeline.hpp"
+
+/*
+ * Holds on to resources that work already handed to the GPU may still use, and destroys them once
+ * the graphics timeline shows that work has completed, along with the frame being recorded.
+ */
+class DeletionQueue {
+public:
+    // Without timelines every deleter waits for flush. frameTimeline is the one only frames
+    // signal, holding the value the renderer reserved for the frame being recorded.
+    void create(Timeline& timeline, Timeline& frameTimeline);
+
+    // Runs deleter once everything submitted so far, and the frame being recorded, is done.
+    // Deleters capturing more than two pointers' worth allocate, which is fine for resources
+    // that are replaced or destroyed, but retiring something every frame has to stay under that.
+    void push(std::function<void()> deleter);
+    // Destroy raw handles the same way, Buffer, Image and Pipeline have a retire of their own.
+    void retireImageView(VkDevice device, VkImageView imageView);
+    void retireSampler(VkDevice device, VkSampler sampler);
+    // Runs the deleters whose work has completed, this never blocks.
+    void collect();
+    // Runs every deleter, call once the device is idle.
+    void flush();
+
+private:
+    struct Entry {
+        uint64_t timelineValue;
+        uint64_t frameValue;
+        std::function<void()> deleter;
+    };
+
+    Timeline* timeline = nullptr;
+    Timeline* frameTimeline = nullptr;
+    std::vector<Entry> entries;
+};
\ No newline at end of file
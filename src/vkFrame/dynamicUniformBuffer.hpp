@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "buffer.hpp"
+
+/*
+ * Packs many T's into one persistently mapped buffer that is bound as a dynamic uniform buffer,
+ * each draw selects its T with the offset push returns. Each frame in flight owns a slice of the
+ * buffer, so writing one frame's data never touches memory the GPU may still be reading.
+ */
+template <typename T> class DynamicUniformBuffer {
+public:
+    void create(VkPhysicalDevice physicalDevice, const uint32_t maxFramesInFlight,
+                const uint32_t maxPerFrame, VmaAllocator allocator,
+                MemoryBudget* memoryBudget = nullptr) {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        // The alignment is always a power of two.
+        VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+        alignedSize = (sizeof(T) + alignment - 1) & ~(alignment - 1);
+        this->maxPerFrame = maxPerFrame;
+        this->allocator = allocator;
+
+        buffer = Buffer(allocator, alignedSize * maxPerFrame * maxFramesInFlight,
+                        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, true, memoryBudget);
+        buffer.map(allocator, &bufferMapped);
+    }
+
+    // Call once per frame before pushing, after the renderer has waited for the frame's slot.
+    void beginFrame(const uint32_t currentFrame) {
+        frameStart = alignedSize * maxPerFrame * currentFrame;
+        frameCount = 0;
+    }
+
+    // Copies data into the current frame's slice and returns the dynamic offset to bind it with.
+    uint32_t push(const T& data) {
+        if (frameCount == maxPerFrame) {
+            throw std::runtime_error("Dynamic uniform buffer is full for this frame!");
+        }
+
+        VkDeviceSize offset = frameStart + alignedSize * frameCount;
+        memcpy(static_cast<char*>(bufferMapped) + offset, &data, sizeof(T));
+        buffer.flush(allocator, offset, sizeof(T));
+        frameCount++;
+
+        return static_cast<uint32_t>(offset);
+    }
+
+    const VkBuffer& getBuffer() { return buffer.getBuffer(); }
+
+    // The descriptor range, each dynamic offset selects one T.
+    size_t getDataSize() { return sizeof(T); }
+
+    void destroy(VmaAllocator allocator) {
+        buffer.unmap(allocator);
+        buffer.destroy(allocator);
+    }
+
+private:
+    Buffer buffer;
+    void* bufferMapped = nullptr;
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    VkDeviceSize alignedSize = 0;
+    uint32_t maxPerFrame = 0;
+    VkDeviceSize frameStart = 0;
+    uint32_t frameCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "geometryArena.hpp"
+
+void GeometryArena::create(VmaAllocator allocator, VkDeviceSize vertexCapacity,
+                           VkDeviceSize indexCapacity, MemoryBudget* memoryBudget) {
+    this->memoryBudget = memoryBudget;
+
+    vertexBuffer = Buffer(allocator, vertexCapacity,
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                          false, memoryBudget);
+    indexBuffer = Buffer(allocator, indexCapacity,
+                         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                         false, memoryBudget);
+
+    vertexFreeList.reset(vertexCapacity);
+    indexFreeList.reset(indexCapacity);
+}
+
+void GeometryArena::destroy(VmaAllocator allocator) {
+    vertexBuffer.destroy(allocator);
+    indexBuffer.destroy(allocator);
+}
+
+GeometryRange GeometryArena::allocateVertices(VkDeviceSize byteSize, VkDeviceSize vertexSize) {
+    return allocate(vertexFreeList, byteSize, vertexSize);
+}
+
+GeometryRange GeometryArena::allocateIndices(VkDeviceSize byteSize, VkDeviceSize indexSize) {
+    return allocate(indexFreeList, byteSize, indexSize);
+}
+
+void GeometryArena::freeVertices(const GeometryRange& range) {
+    vertexFreeList.free(range.offset, range.size);
+}
+
+void GeometryArena::freeIndices(const GeometryRange& range) {
+    indexFreeList.free(range.offset, range.size);
+}
+
+void GeometryArena::bind(VkCommandBuffer commandBuffer, VkIndexType indexType) {
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.getBuffer(), offsets);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer.getBuffer(), 0, indexType);
+}
+
+Buffer& GeometryArena::getVertexBuffer() { return vertexBuffer; }
+
+Buffer& GeometryArena::getIndexBuffer() { return indexBuffer; }
+
+MemoryBudget* GeometryArena::getMemoryBudget() { return memoryBudget; }
+
+GeometryRange GeometryArena::allocate(FreeList& freeList, VkDeviceSize byteSize,
+                                      VkDeviceSize alignment) {
+    GeometryRange range;
+    if (byteSize == 0)
+        return range;
+
+    if (!freeList.allocate(byteSize, alignment, range.offset)) {
+        throw std::runtime_error("Geometry arena is full!");
+    }
+
+    range.size = byteSize;
+    return range;
+}
+
+void GeometryArena::FreeList::reset(VkDeviceSize capacity) {
+    ranges.clear();
+    if (capacity != 0) {
+        ranges[0] = capacity;
+    }
+}
+
+bool GeometryArena::FreeList::allocate(VkDeviceSize size, VkDeviceSize alignment,
+                                       VkDeviceSize& offset) {
+    // First fit, vertex sizes aren't always powers of two so neither is the alignment.
+    for (auto it = ranges.begin(); it != ranges.end(); it++) {
+        VkDeviceSize rangeOffset = it->first;
+        VkDeviceSize rangeEnd = it->first + it->second;
+        VkDeviceSize alignedOffset = (rangeOffset + alignment - 1) / alignment * alignment;
+
+        if (alignedOffset + size > rangeEnd)
+            continue;
+
+        ranges.erase(it);
+
+        // Whatever is left on either side of the allocation stays free.
+        if (alignedOffset > rangeOffset) {
+            ranges[rangeOffset] = alignedOffset - rangeOffset;
+        }
+
+        if (alignedOffset + size < rangeEnd) {
+            ranges[alignedOffset + size] = rangeEnd - alignedOffset - size;
+        }
+
+        offset = alignedOffset;
+        return true;
+    }
+
+    return false;
+}
+
+void GeometryArena::FreeList::free(VkDeviceSize offset, VkDeviceSize size) {
+    if (size == 0)
+        return;
+
+    auto next = ranges.lower_bound(offset);
+
+    // Merge with the free range directly after this one.
+    if (next != ranges.end() && offset + size == next->first) {
+        size += next->second;
+        next = ranges.erase(next);
+    }
+
+    // Merge with the free range directly before this one.
+    if (next != ranges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+
+    ranges[offset] = size;
+}
\ No newline at end of file
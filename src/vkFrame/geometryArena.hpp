@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+#include "buffer.hpp"
+
+struct GeometryRange {
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+};
+
+/*
+ * One large vertex buffer and one large index buffer that every Model sub-allocates its mesh
+ * from, so models share a single buffer bind and a handful of VMA allocations. Free space is kept
+ * as a list of ranges ordered by offset, neighbouring free ranges are merged when released.
+ */
+class GeometryArena {
+public:
+    // The buffers are reported to memoryBudget when there is one, as are the instance buffers of
+    // the models that allocate from the arena.
+    void create(VmaAllocator allocator, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity,
+                MemoryBudget* memoryBudget = nullptr);
+    void destroy(VmaAllocator allocator);
+
+    // Ranges are aligned to the element size so they can be addressed with vertexOffset and
+    // firstIndex, throws if the arena is full.
+    GeometryRange allocateVertices(VkDeviceSize byteSize, VkDeviceSize vertexSize);
+    GeometryRange allocateIndices(VkDeviceSize byteSize, VkDeviceSize indexSize);
+    // The GPU must be done with a range before it is freed, retire it through the deletion queue.
+    void freeVertices(const GeometryRange& range);
+    void freeIndices(const GeometryRange& range);
+
+    // Binds the vertex buffer to binding 0 and the index buffer at offset 0.
+    void bind(VkCommandBuffer commandBuffer, VkIndexType indexType);
+
+    Buffer& getVertexBuffer();
+    Buffer& getIndexBuffer();
+    MemoryBudget* getMemoryBudget();
+
+private:
+    class FreeList {
+    public:
+        void reset(VkDeviceSize capacity);
+        bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+        void free(VkDeviceSize offset, VkDeviceSize size);
+
+    private:
+        // Offset to size of every free range.
+        std::map<VkDeviceSize, VkDeviceSize> ranges;
+    };
+
+    GeometryRange allocate(FreeList& freeList, VkDeviceSize byteSize, VkDeviceSize alignment);
+
+    Buffer vertexBuffer;
+    Buffer indexBuffer;
+    MemoryBudget* memoryBudget = nullptr;
+    FreeList vertexFreeList;
+    FreeList indexFreeList;
+};
\ No newline at end of file
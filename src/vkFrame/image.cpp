@@ -9,7 +9,8 @@ Image::Image(VkImage image, VmaAllocation allocation, VkFormat format)
 
 Image::Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat format,
              VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-             uint32_t mipmapLevels, uint32_t layers, VkSampleCountFlagBits samples)
+             uint32_t mipmapLevels, uint32_t layers, VkSampleCountFlagBits samples,
+             MemoryBudget* memoryBudget)
     : format(format) {
 
     layerCount = layers;
@@ -30,6 +31,7 @@ Image::Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat f
 
     VmaAllocationCreateInfo aci = {};
     aci.usage = VMA_MEMORY_USAGE_AUTO;
+    aci.pUserData = MemoryBudget::tag(memoryBudget, MemoryBudget::categorizeImage(usage));
 
     VkImage image;
     VmaAllocation allocation;
@@ -37,6 +39,7 @@ Image::Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat f
     if (vmaCreateImage(allocator, &imageInfo, &aci, &image, &allocation, nullptr) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate image memory!");
     }
+    MemoryBudget::track(allocator, allocation);
 
     this->width = width;
     this->height = height;
@@ -45,159 +48,142 @@ Image::Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat f
     this->allocation = allocation;
 }
 
-void Image::generateMipmaps(Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    VkCommandBuffer commandBuffer = commands.beginSingleTime(graphicsQueue, device);
+MipChain Image::loadMipChain(const std::string& image, bool enableMipmaps, uint32_t width,
+                             uint32_t height, uint32_t layers, const MipCache* mipCache) {
+    int32_t texWidth, texHeight, texChannels;
+    stbi_uc* pixels =
+        stbi_load(image.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = layerCount;
-    barrier.subresourceRange.levelCount = 1;
-
-    int32_t mipmapWidth = width;
-    int32_t mipmapHeight = height;
-
-    for (uint32_t i = 1; i < mipmapLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                             &barrier);
-
-        VkImageBlit blit{};
-        blit.srcOffsets[0] = {0, 0, 0};
-        blit.srcOffsets[1] = {mipmapWidth, mipmapHeight, 1};
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = layerCount;
-        blit.dstOffsets[0] = {0, 0, 0};
-        blit.dstOffsets[1] = {mipmapWidth > 1 ? mipmapWidth / 2 : 1,
-                              mipmapHeight > 1 ? mipmapHeight / 2 : 1, 1};
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = layerCount;
-
-        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
-                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
-
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                             &barrier);
-
-        if (mipmapWidth > 1) {
-            mipmapWidth /= 2;
-        }
-
-        if (mipmapHeight > 1) {
-            mipmapHeight /= 2;
-        }
+    if (!pixels) {
+        throw std::runtime_error("Failed to load texture image!");
     }
 
-    barrier.subresourceRange.baseMipLevel = mipmapLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    if (width == 0) {
+        width = texWidth;
+        height = texHeight;
+    }
 
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                         &barrier);
+    uint32_t mipmapLevels = enableMipmaps ? calcMipmapLevels(width, height) : 1;
 
-    commands.endSingleTime(commandBuffer, graphicsQueue, device);
+    try {
+        MipChain chain = MipChain::build(pixels, texWidth, texHeight, width, height, layers,
+                                         mipmapLevels, true, mipCache);
+        stbi_image_free(pixels);
+        return chain;
+    } catch (...) {
+        stbi_image_free(pixels);
+        throw;
+    }
 }
 
-Buffer Image::loadImage(const std::string& image, VmaAllocator allocator, int32_t& width,
-                        int32_t& height) {
-    int32_t texChannels;
-    stbi_uc* pixels = stbi_load(image.c_str(), &width, &height, &texChannels, STBI_rgb_alpha);
-    size_t imageSize = width * height;
-    VkDeviceSize imageByteSize = imageSize * 4;
+Image Image::createTexture(const std::string& image, VmaAllocator allocator, Commands& commands,
+                           VkQueue graphicsQueue, VkDevice device, bool enableMipmaps,
+                           const MipCache* mipCache, MemoryBudget* memoryBudget) {
+    UploadBatch batch;
+    batch.begin(allocator, commands, graphicsQueue, device, memoryBudget);
+    Image textureImage = createTexture(image, batch, enableMipmaps, mipCache);
+    batch.submit();
+    batch.wait();
 
-    if (!pixels) {
-        throw std::runtime_error("Failed to load texture image!");
-    }
+    return textureImage;
+}
 
-    Buffer stagingBuffer(allocator, imageByteSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, true);
-    stagingBuffer.setData(pixels);
+Image Image::createTextureArray(const std::string& image, VmaAllocator allocator,
+                                Commands& commands, VkQueue graphicsQueue, VkDevice device,
+                                bool enableMipmaps, uint32_t width, uint32_t height,
+                                uint32_t layers, const MipCache* mipCache,
+                                MemoryBudget* memoryBudget) {
+    UploadBatch batch;
+    batch.begin(allocator, commands, graphicsQueue, device, memoryBudget);
+    Image textureImage =
+        createTextureArray(image, batch, enableMipmaps, width, height, layers, mipCache);
+    batch.submit();
+    batch.wait();
 
-    stbi_image_free(pixels);
+    return textureImage;
+}
 
-    return stagingBuffer;
+Image Image::createTexture(const std::string& image, UploadBatch& batch, bool enableMipmaps,
+                           const MipCache* mipCache) {
+    return createTexture(batch, loadMipChain(image, enableMipmaps, 0, 0, 1, mipCache));
 }
 
-Image Image::createTexture(const std::string& image, VmaAllocator allocator, Commands& commands,
-                           VkQueue graphicsQueue, VkDevice device, bool enableMipmaps) {
-    int32_t texWidth, texHeight;
-    Buffer stagingBuffer = loadImage(image, allocator, texWidth, texHeight);
-    uint32_t mipMapLevels = enableMipmaps ? calcMipmapLevels(texWidth, texHeight) : 1;
+Image Image::createTextureArray(const std::string& image, UploadBatch& batch, bool enableMipmaps,
+                                uint32_t width, uint32_t height, uint32_t layers,
+                                const MipCache* mipCache) {
+    return createTexture(batch,
+                         loadMipChain(image, enableMipmaps, width, height, layers, mipCache));
+}
 
-    Image textureImage =
-        Image(allocator, texWidth, texHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                  VK_IMAGE_USAGE_SAMPLED_BIT,
-              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mipMapLevels);
+Image Image::createTexture(UploadBatch& batch, const MipChain& chain) {
+    StagingAllocation staging = batch.stage(chain.getData().data(), chain.getData().size());
 
-    textureImage.transitionImageLayout(commands, VK_IMAGE_LAYOUT_UNDEFINED,
-                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, graphicsQueue, device);
-    textureImage.copyFromBuffer(stagingBuffer, commands, graphicsQueue, device);
+    return createTextureFromLevels(batch, staging, VK_FORMAT_R8G8B8A8_SRGB, chain.getWidth(),
+                                   chain.getHeight(), chain.getLayerCount(), chain.getLevels());
+}
 
-    stagingBuffer.destroy(allocator);
+Image Image::createTextureFromLevels(UploadBatch& batch, const StagingAllocation& levelData,
+                                     VkFormat format, uint32_t width, uint32_t height,
+                                     uint32_t layerCount, const std::vector<TextureLevel>& levels) {
+    uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+    Image textureImage(batch.getAllocator(), width, height, format, VK_IMAGE_TILING_OPTIMAL,
+                       VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, levelCount, layerCount,
+                       VK_SAMPLE_COUNT_1_BIT, batch.getMemoryBudget());
+
+    // Every level is tightly packed, with all of its layers one after the other.
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        VkBufferImageCopy& region = regions[i];
+        region.bufferOffset = levelData.offset + levels[i].offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = layerCount;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {levels[i].width, levels[i].height, 1};
+    }
 
-    textureImage.generateMipmaps(commands, graphicsQueue, device);
+    VkCommandBuffer commandBuffer = batch.getCommandBuffer();
+    textureImage.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    vkCmdCopyBufferToImage(commandBuffer, levelData.buffer, textureImage.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, levelCount, regions.data());
+    textureImage.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
     return textureImage;
 }
 
-Image Image::createTextureArray(const std::string& image, VmaAllocator allocator,
-                                Commands& commands, VkQueue graphicsQueue, VkDevice device,
-                                bool enableMipmaps, uint32_t width, uint32_t height,
-                                uint32_t layers) {
-    int32_t texWidth, texHeight;
-    Buffer stagingBuffer = loadImage(image, allocator, texWidth, texHeight);
-    uint32_t mipMapLevels = enableMipmaps ? calcMipmapLevels(width, height) : 1;
-
-    Image textureImage =
-        Image(allocator, width, height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                  VK_IMAGE_USAGE_SAMPLED_BIT,
-              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mipMapLevels, layers);
+Image Image::createCompressedTexture(const std::string& path, VkPhysicalDevice physicalDevice,
+                                     UploadBatch& batch) {
+    CompressedTexture texture = CompressedTexture::fromFile(path);
 
-    textureImage.transitionImageLayout(commands, VK_IMAGE_LAYOUT_UNDEFINED,
-                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, graphicsQueue, device);
-    textureImage.copyFromBuffer(stagingBuffer, commands, graphicsQueue, device, texWidth,
-                                texHeight);
+    if (!CompressedTexture::isSupported(physicalDevice, texture.getFormat())) {
+        if (!texture.canTranscode()) {
+            throw std::runtime_error(
+                "Compressed texture format isn't supported by the device and can't be transcoded!");
+        }
 
-    stagingBuffer.destroy(allocator);
+        texture.transcode();
+    }
 
-    textureImage.generateMipmaps(commands, graphicsQueue, device);
+    StagingAllocation staging = batch.stage(texture.getData().data(), texture.getData().size());
 
-    return textureImage;
+    return createTextureFromLevels(batch, staging, texture.getFormat(), texture.getWidth(),
+                                   texture.getHeight(), texture.getLayerCount(),
+                                   texture.getLevels());
 }
 
-VkImageView Image::createTextureView(VkDevice device) {
-    return createView(VK_IMAGE_ASPECT_COLOR_BIT, device);
+VkImageView Image::createTextureView(VkDevice device, uint32_t baseMipLevel) {
+    return createView(VK_IMAGE_ASPECT_COLOR_BIT, device, baseMipLevel);
 }
 
-VkSampler Image::createTextureSampler(VkPhysicalDevice physicalDevice, VkDevice device,
-                                      VkFilter minFilter, VkFilter magFilter) {
-    VkPhysicalDeviceProperties properties{};
-    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
-
+VkSampler Image::createTextureSampler(SamplerCache& samplerCache, VkFilter minFilter,
+                                      VkFilter magFilter) {
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = magFilter;
@@ -206,24 +192,19 @@ VkSampler Image::createTextureSampler(VkPhysicalDevice physicalDevice, VkDevice
     samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+    samplerInfo.maxAnisotropy = samplerCache.getMaxAnisotropy();
     samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.maxLod = static_cast<float>(mipmapLevels);
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-    VkSampler textureSampler;
-
-    if (vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create texture sampler!");
-    }
-
-    return textureSampler;
+    return samplerCache.acquire(samplerInfo);
 }
 
-VkImageView Image::createView(VkImageAspectFlags aspectFlags, VkDevice device) {
+VkImageView Image::createView(VkImageAspectFlags aspectFlags, VkDevice device,
+                              uint32_t baseMipLevel) {
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = image;
@@ -231,8 +212,8 @@ VkImageView Image::createView(VkImageAspectFlags aspectFlags, VkDevice device) {
     viewInfo.format = format;
     viewInfo.subresourceRange = {};
     viewInfo.subresourceRange.aspectMask = aspectFlags;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = mipmapLevels;
+    viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+    viewInfo.subresourceRange.levelCount = mipmapLevels - baseMipLevel;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = layerCount;
 
@@ -244,10 +225,9 @@ VkImageView Image::createView(VkImageAspectFlags aspectFlags, VkDevice device) {
     return imageView;
 }
 
-void Image::transitionImageLayout(Commands& commands, VkImageLayout oldLayout,
-                                  VkImageLayout newLayout, VkQueue graphicsQueue, VkDevice device) {
-    VkCommandBuffer commandBuffer = commands.beginSingleTime(graphicsQueue, device);
-
+void Image::transitionImageLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout,
+                                  VkImageLayout newLayout, uint32_t baseMipLevel,
+                                  uint32_t levelCount) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -256,8 +236,8 @@ void Image::transitionImageLayout(Commands& commands, VkImageLayout oldLayout,
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = mipmapLevels;
+    barrier.subresourceRange.baseMipLevel = baseMipLevel;
+    barrier.subresourceRange.levelCount = levelCount;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = layerCount;
 
@@ -291,11 +271,9 @@ void Image::transitionImageLayout(Commands& commands, VkImageLayout oldLayout,
 
     vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1,
                          &barrier);
-
-    commands.endSingleTime(commandBuffer, graphicsQueue, device);
 }
 
-void Image::copyFromBuffer(Buffer& src, Commands& commands, VkQueue graphicsQueue, VkDevice device,
+void Image::copyFromBuffer(VkCommandBuffer commandBuffer, const StagingAllocation& src,
                            uint32_t fullWidth, uint32_t fullHeight) {
     if (fullWidth == 0) {
         fullWidth = width;
@@ -305,8 +283,6 @@ void Image::copyFromBuffer(Buffer& src, Commands& commands, VkQueue graphicsQueu
         fullHeight = height;
     }
 
-    VkCommandBuffer commandBuffer = commands.beginSingleTime(graphicsQueue, device);
-
     std::vector<VkBufferImageCopy> regions;
     uint32_t texPerRow = fullWidth / width;
 
@@ -315,7 +291,7 @@ void Image::copyFromBuffer(Buffer& src, Commands& commands, VkQueue graphicsQueu
         uint32_t yLayer = layer / texPerRow;
 
         VkBufferImageCopy region = {};
-        region.bufferOffset = (xLayer * width + yLayer * height * fullWidth) * 4;
+        region.bufferOffset = src.offset + (xLayer * width + yLayer * height * fullWidth) * 4;
         region.bufferRowLength = fullWidth;
         region.bufferImageHeight = fullHeight;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -327,19 +303,46 @@ void Image::copyFromBuffer(Buffer& src, Commands& commands, VkQueue graphicsQueu
         regions.push_back(region);
     }
 
-    vkCmdCopyBufferToImage(commandBuffer, src.getBuffer(), image,
+    vkCmdCopyBufferToImage(commandBuffer, src.buffer, image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            static_cast<uint32_t>(regions.size()), regions.data());
+}
 
-    commands.endSingleTime(commandBuffer, graphicsQueue, device);
+void Image::copyLevelFromBuffer(VkCommandBuffer commandBuffer, const StagingAllocation& src,
+                                uint32_t mipLevel, VkDeviceSize offset) {
+    VkBufferImageCopy region{};
+    region.bufferOffset = src.offset + offset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = mipLevel;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = layerCount;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {std::max(width >> mipLevel, 1u), std::max(height >> mipLevel, 1u), 1};
+
+    vkCmdCopyBufferToImage(commandBuffer, src.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &region);
 }
 
 uint32_t Image::calcMipmapLevels(int32_t texWidth, int32_t texHeight) {
     return static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
 }
 
-void Image::destroy(VmaAllocator allocator) { vmaDestroyImage(allocator, image, allocation); }
+void Image::destroy(VmaAllocator allocator) {
+    MemoryBudget::untrack(allocator, allocation);
+    vmaDestroyImage(allocator, image, allocation);
+}
+
+void Image::retire(VmaAllocator allocator, DeletionQueue& deletionQueue) {
+    deletionQueue.push([allocator, image = image, allocation = allocation] {
+        MemoryBudget::untrack(allocator, allocation);
+        vmaDestroyImage(allocator, image, allocation);
+    });
+}
 
 uint32_t Image::getWidth() const { return width; }
 
-uint32_t Image::getHeight() const { return height; }
\ No newline at end of file
+uint32_t Image::getHeight() const { return height; }
+
+uint32_t Image::getMipmapLevels() const { return mipmapLevels; }
\ No newline at end of file
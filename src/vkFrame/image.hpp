@@ -8,47 +8,90 @@
 #include "../../deps/stb_image.h"
 
 #include "buffer.hpp"
+#include "compressedTexture.hpp"
+#include "mipChain.hpp"
+#include "samplerCache.hpp"
 
 class Image {
 public:
     static Image createTexture(const std::string& image, VmaAllocator allocator, Commands& commands,
-                               VkQueue graphicsQueue, VkDevice device, bool enableMipmaps);
+                               VkQueue graphicsQueue, VkDevice device, bool enableMipmaps,
+                               const MipCache* mipCache = nullptr,
+                               MemoryBudget* memoryBudget = nullptr);
     static Image createTextureArray(const std::string& image, VmaAllocator allocator,
                                     Commands& commands, VkQueue graphicsQueue, VkDevice device,
                                     bool enableMipmaps, uint32_t width, uint32_t height,
-                                    uint32_t layers);
+                                    uint32_t layers, const MipCache* mipCache = nullptr,
+                                    MemoryBudget* memoryBudget = nullptr);
+    // Record the upload into batch, the texture can't be used until the batch has been submitted.
+    // Mipmaps are generated on the CPU, or read from mipCache when there is one, and uploaded with
+    // the texture.
+    static Image createTexture(const std::string& image, UploadBatch& batch, bool enableMipmaps,
+                               const MipCache* mipCache = nullptr);
+    static Image createTextureArray(const std::string& image, UploadBatch& batch,
+                                    bool enableMipmaps, uint32_t width, uint32_t height,
+                                    uint32_t layers, const MipCache* mipCache = nullptr);
+    // Loads a KTX2 or DDS file with all of its mip levels. Formats the device can't sample are
+    // decompressed to RGBA8 on the CPU where CompressedTexture can transcode them.
+    static Image createCompressedTexture(const std::string& path, VkPhysicalDevice physicalDevice,
+                                         UploadBatch& batch);
+    static Image createTexture(UploadBatch& batch, const MipChain& chain);
+    // Creates a texture with every level in levels from levelData in the staging ring, each level
+    // holding all of its layers one after the other. The data only has to be written by the time
+    // the batch is submitted.
+    static Image createTextureFromLevels(UploadBatch& batch, const StagingAllocation& levelData,
+                                         VkFormat format, uint32_t width, uint32_t height,
+                                         uint32_t layerCount,
+                                         const std::vector<TextureLevel>& levels);
 
     Image();
     Image(VkImage image, VkFormat format);
     Image(VkImage image, VmaAllocation allocation, VkFormat format);
+    // The allocation is reported to memoryBudget when there is one.
     Image(VmaAllocator allocator, uint32_t width, uint32_t height, VkFormat format,
           VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
           uint32_t mipmapLevels = 1, uint32_t layers = 1,
-          VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
-    VkImageView createTextureView(VkDevice device);
-    VkSampler createTextureSampler(VkPhysicalDevice physicalDevice, VkDevice device,
-                                   VkFilter minFilter = VK_FILTER_LINEAR,
-                                   VkFilter magFilter = VK_FILTER_LINEAR);
-    VkImageView createView(VkImageAspectFlags aspectFlags, VkDevice device);
-    void transitionImageLayout(Commands& commands, VkImageLayout oldLayout, VkImageLayout newLayout,
-                               VkQueue graphicsQueue, VkDevice device);
-    void copyFromBuffer(Buffer& src, Commands& commands, VkQueue graphicsQueue, VkDevice device,
+          VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+          MemoryBudget* memoryBudget = nullptr);
+    // A view of the levels from baseMipLevel down, the ones above it are never sampled.
+    VkImageView createTextureView(VkDevice device, uint32_t baseMipLevel = 0);
+    // A repeating, anisotropic sampler shared through samplerCache, release it there. It
+    // doesn't clamp the LOD, so the same sampler works for textures with any number of levels.
+    static VkSampler createTextureSampler(SamplerCache& samplerCache,
+                                          VkFilter minFilter = VK_FILTER_LINEAR,
+                                          VkFilter magFilter = VK_FILTER_LINEAR);
+    VkImageView createView(VkImageAspectFlags aspectFlags, VkDevice device,
+                           uint32_t baseMipLevel = 0);
+    void transitionImageLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout,
+                               VkImageLayout newLayout, uint32_t baseMipLevel = 0,
+                               uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
+    void copyFromBuffer(VkCommandBuffer commandBuffer, const StagingAllocation& src,
                         uint32_t fullWidth = 0, uint32_t fullHeight = 0);
-    void generateMipmaps(Commands& commands, VkQueue graphicsQueue, VkDevice device);
+    // Copies every layer of mipLevel from offset in src, where the layers follow each other.
+    void copyLevelFromBuffer(VkCommandBuffer commandBuffer, const StagingAllocation& src,
+                             uint32_t mipLevel, VkDeviceSize offset = 0);
     void destroy(VmaAllocator allocator);
+    // Destroys the image once the frames that may still use it have completed.
+    void retire(VmaAllocator allocator, DeletionQueue& deletionQueue);
     uint32_t getWidth() const;
     uint32_t getHeight() const;
+    uint32_t getMipmapLevels() const;
+
+    // Levels in a full mip chain down to 1x1.
+    static uint32_t calcMipmapLevels(int32_t texWidth, int32_t texHeight);
+    // Decodes an image into a MipChain, cutting it into layers of width * height texels like
+    // createTextureArray. A width of zero takes the whole image as a single layer.
+    static MipChain loadMipChain(const std::string& image, bool enableMipmaps, uint32_t width,
+                                 uint32_t height, uint32_t layers,
+                                 const MipCache* mipCache = nullptr);
 
 private:
     VkImage image;
-    VmaAllocation allocation;
+    VmaAllocation allocation = VK_NULL_HANDLE;
     VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
     uint32_t layerCount = 1;
     uint32_t width = 0;
     uint32_t height = 0;
     uint32_t mipmapLevels = 1;
 
-    static Buffer loadImage(const std::string& image, VmaAllocator allocator, int32_t& width,
-                            int32_t& height);
-    static uint32_t calcMipmapLevels(int32_t texWidth, int32_t texHeight);
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "memoryBudget.hpp"
+
+MemoryCategory MemoryBudget::categorizeBuffer(VkBufferUsageFlags usage) {
+    // Buffers that are only ever copied from exist to stage uploads.
+    return usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT ? MemoryCategory::Staging
+                                                     : MemoryCategory::Buffer;
+}
+
+MemoryCategory MemoryBudget::categorizeImage(VkImageUsageFlags usage) {
+    const VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                              VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+    return (usage & attachmentUsage) ? MemoryCategory::RenderTarget : MemoryCategory::Texture;
+}
+
+void* MemoryBudget::tag(MemoryBudget* budget, MemoryCategory category) {
+    if (budget == nullptr)
+        return nullptr;
+
+    return &budget->categoryTags[static_cast<size_t>(category)];
+}
+
+void MemoryBudget::track(VmaAllocator allocator, VmaAllocation allocation) {
+    if (allocation == VK_NULL_HANDLE)
+        return;
+
+    VmaAllocationInfo allocInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocInfo);
+
+    auto* categoryTag = static_cast<CategoryTag*>(allocInfo.pUserData);
+    if (categoryTag == nullptr)
+        return;
+
+    size_t category = static_cast<size_t>(categoryTag->category);
+    categoryTag->budget->categoryBytes[category] += allocInfo.size;
+    categoryTag->budget->categoryCounts[category]++;
+}
+
+void MemoryBudget::untrack(VmaAllocator allocator, VmaAllocation allocation) {
+    if (allocation == VK_NULL_HANDLE)
+        return;
+
+    VmaAllocationInfo allocInfo;
+    vmaGetAllocationInfo(allocator, allocation, &allocInfo);
+
+    auto* categoryTag = static_cast<CategoryTag*>(allocInfo.pUserData);
+    if (categoryTag == nullptr)
+        return;
+
+    size_t category = static_cast<size_t>(categoryTag->category);
+    categoryTag->budget->categoryBytes[category] -= allocInfo.size;
+    categoryTag->budget->categoryCounts[category]--;
+}
+
+void MemoryBudget::create(VkPhysicalDevice physicalDevice, VmaAllocator allocator,
+                          bool budgetSupported) {
+    this->allocator = allocator;
+    this->budgetSupported = budgetSupported;
+    frameNumber = 0;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    for (size_t i = 0; i < memoryCategoryCount; i++) {
+        categoryBytes[i] = 0;
+        categoryCounts[i] = 0;
+    }
+
+    beginFrame();
+}
+
+void MemoryBudget::destroy() {
+    static const char* categoryNames[memoryCategoryCount] = {"buffer", "texture", "render target",
+                                                             "staging"};
+
+    for (size_t i = 0; i < memoryCategoryCount; i++) {
+        if (categoryCounts[i] != 0) {
+            std::cerr << "Leaked " << categoryCounts[i] << " " << categoryNames[i]
+                      << " allocations holding " << categoryBytes[i] << " bytes!" << std::endl;
+        }
+    }
+
+    allocator = VK_NULL_HANDLE;
+}
+
+void MemoryBudget::beginFrame() {
+    // VMA only asks the driver for new budgets every few frames, going by the frame index.
+    vmaSetCurrentFrameIndex(allocator, static_cast<uint32_t>(frameNumber));
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        HeapBudget& heapBudget = heapBudgets[i];
+        heapBudget.usage = budgets[i].usage;
+        heapBudget.budget = budgets[i].budget;
+        heapBudget.blockBytes = budgets[i].statistics.blockBytes;
+        heapBudget.allocationBytes = budgets[i].statistics.allocationBytes;
+        heapBudget.deviceLocal =
+            memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    }
+
+    if (statsInterval != 0 && frameNumber != 0 && frameNumber % statsInterval == 0) {
+        writeStats(statsPath);
+    }
+
+    frameNumber++;
+}
+
+bool MemoryBudget::isBudgetSupported() const { return budgetSupported; }
+
+uint32_t MemoryBudget::getHeapCount() const { return memoryProperties.memoryHeapCount; }
+
+const HeapBudget& MemoryBudget::getHeapBudget(uint32_t heapIndex) const {
+    return heapBudgets[heapIndex];
+}
+
+VkDeviceSize MemoryBudget::getCategoryBytes(MemoryCategory category) const {
+    return categoryBytes[static_cast<size_t>(category)];
+}
+
+uint32_t MemoryBudget::getCategoryCount(MemoryCategory category) const {
+    return categoryCounts[static_cast<size_t>(category)];
+}
+
+void MemoryBudget::setStatsDump(const std::string& path, uint32_t intervalFrames) {
+    statsPath = path;
+    statsInterval = intervalFrames;
+}
+
+void MemoryBudget::writeStats(const std::string& path) {
+    static const char* categoryNames[memoryCategoryCount] = {"buffers", "textures",
+                                                             "renderTargets", "staging"};
+
+    char* vmaStats = nullptr;
+    vmaBuildStatsString(allocator, &vmaStats, VK_TRUE);
+
+    // Written to a temporary file first so that whatever reads the dump never sees half of it.
+    // Failing to write isn't an error, the next dump will try again.
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            vmaFreeStatsString(allocator, vmaStats);
+            return;
+        }
+
+        file << "{\"frame\":" << frameNumber << ",\"budgetSupported\":"
+             << (budgetSupported ? "true" : "false") << ",\n\"heaps\":[";
+        for (uint32_t i = 0; i < getHeapCount(); i++) {
+            const HeapBudget& heapBudget = heapBudgets[i];
+            file << (i == 0 ? "\n" : ",\n");
+            file << "{\"usage\":" << heapBudget.usage << ",\"budget\":" << heapBudget.budget
+                 << ",\"blockBytes\":" << heapBudget.blockBytes
+                 << ",\"allocationBytes\":" << heapBudget.allocationBytes
+                 << ",\"deviceLocal\":" << (heapBudget.deviceLocal ? "true" : "false") << "}";
+        }
+
+        file << "\n],\n\"categories\":{";
+        for (size_t i = 0; i < memoryCategoryCount; i++) {
+            file << (i == 0 ? "\n" : ",\n");
+            file << "\"" << categoryNames[i] << "\":{\"bytes\":" << categoryBytes[i]
+                 << ",\"count\":" << categoryCounts[i] << "}";
+        }
+
+        file << "\n},\n\"vma\":" << vmaStats << "}\n";
+        file.close();
+
+        vmaFreeStatsString(allocator, vmaStats);
+
+        if (!file) {
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+
+    if (error) {
+        std::remove(tempPath.c_str());
+    }
+}
\ No newline at end of file
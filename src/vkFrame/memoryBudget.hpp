@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+enum class MemoryCategory { Buffer, Texture, RenderTarget, Staging };
+
+const size_t memoryCategoryCount = 4;
+
+struct HeapBudget {
+    // Bytes of the heap used by this process, and how much it can use before the driver starts
+    // evicting or failing allocations. Without VK_EXT_memory_budget both are VMA's estimates.
+    VkDeviceSize usage = 0;
+    VkDeviceSize budget = 0;
+    // Bytes in VkDeviceMemory blocks VMA allocated, and the part of them handed out.
+    VkDeviceSize blockBytes = 0;
+    VkDeviceSize allocationBytes = 0;
+    bool deviceLocal = false;
+};
+
+/*
+ * Reports how much of each memory heap is in use against the budget the driver gives the process,
+ * and how many bytes every category of resource holds. Buffer, Image and StagingRing tag their
+ * allocations with the budget they were given and a category when creating them and report them
+ * here, so leaks show up as categories that aren't empty when the renderer shuts down.
+ */
+class MemoryBudget {
+public:
+    static MemoryCategory categorizeBuffer(VkBufferUsageFlags usage);
+    static MemoryCategory categorizeImage(VkImageUsageFlags usage);
+    // Set as VmaAllocationCreateInfo::pUserData so track and untrack know the budget and the
+    // category. Null when budget is, the allocation then isn't tracked.
+    static void* tag(MemoryBudget* budget, MemoryCategory category);
+    // Either does nothing for an untagged or null allocation.
+    static void track(VmaAllocator allocator, VmaAllocation allocation);
+    static void untrack(VmaAllocator allocator, VmaAllocation allocation);
+
+    // budgetSupported is whether the allocator was created with VK_EXT_memory_budget.
+    void create(VkPhysicalDevice physicalDevice, VmaAllocator allocator, bool budgetSupported);
+    // Warns about every category still holding allocations.
+    void destroy();
+
+    // Call once per frame, refreshes the heap budgets and writes the stats dump when it is due.
+    void beginFrame();
+
+    bool isBudgetSupported() const;
+    uint32_t getHeapCount() const;
+    // As of the last beginFrame.
+    const HeapBudget& getHeapBudget(uint32_t heapIndex) const;
+    VkDeviceSize getCategoryBytes(MemoryCategory category) const;
+    uint32_t getCategoryCount(MemoryCategory category) const;
+
+    // Every intervalFrames frames the stats are written to path, 0 disables the dump.
+    void setStatsDump(const std::string& path, uint32_t intervalFrames);
+    // Writes the heap budgets, the categories and VMA's detailed statistics as JSON.
+    void writeStats(const std::string& path);
+
+private:
+    struct CategoryTag {
+        MemoryBudget* budget;
+        MemoryCategory category;
+    };
+
+    // What tag hands out, one per category, valid before create so allocations can be tagged
+    // in any order.
+    std::array<CategoryTag, memoryCategoryCount> categoryTags{
+        {{this, MemoryCategory::Buffer},
+         {this, MemoryCategory::Texture},
+         {this, MemoryCategory::RenderTarget},
+         {this, MemoryCategory::Staging}}};
+
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    bool budgetSupported = false;
+    uint64_t frameNumber = 0;
+
+    std::array<HeapBudget, VK_MAX_MEMORY_HEAPS> heapBudgets{};
+    // Textures may be created on worker threads.
+    std::array<std::atomic<uint64_t>, memoryCategoryCount> categoryBytes{};
+    std::array<std::atomic<uint32_t>, memoryCategoryCount> categoryCounts{};
+
+    std::string statsPath;
+    uint32_t statsInterval = 0;
+};
\ No newline at end of file
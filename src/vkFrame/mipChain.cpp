@@ -0,0 +1,353 @@
+#include "mipChain.hpp"
+
+namespace {
+
+const uint32_t cacheMagic = 0x434D4B56; // "VKMC"
+const uint32_t cacheVersion = 1;
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t byteSize;
+};
+
+const uint64_t fnvOffsetBasis = 0xCBF29CE484222325ull;
+const uint64_t fnvPrime = 0x100000001B3ull;
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t byteSize) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < byteSize; i++) {
+        hash = (hash ^ bytes[i]) * fnvPrime;
+    }
+
+    return hash;
+}
+
+// Linear values are quantized to this many steps on the way back to sRGB, enough for every byte
+// value to survive the round trip.
+const uint32_t linearSteps = 4096;
+
+const std::array<float, 256>& srgbToLinear() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (uint32_t i = 0; i < 256; i++) {
+            float value = i / 255.0f;
+            values[i] = value <= 0.04045f ? value / 12.92f
+                                          : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+
+    return table;
+}
+
+const std::array<uint8_t, linearSteps>& linearToSrgb() {
+    static const std::array<uint8_t, linearSteps> table = [] {
+        std::array<uint8_t, linearSteps> values{};
+        for (uint32_t i = 0; i < linearSteps; i++) {
+            float value = static_cast<float>(i) / (linearSteps - 1);
+            float encoded = value <= 0.0031308f ? value * 12.92f
+                                                : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            values[i] = static_cast<uint8_t>(std::lround(encoded * 255.0f));
+        }
+        return values;
+    }();
+
+    return table;
+}
+
+void decodeLayer(const uint8_t* texels, size_t texelCount, bool srgb, float* dst) {
+    const std::array<float, 256>& toLinear = srgbToLinear();
+
+    for (size_t i = 0; i < texelCount; i++) {
+        for (size_t c = 0; c < 3; c++) {
+            dst[i * 4 + c] = srgb ? toLinear[texels[i * 4 + c]] : texels[i * 4 + c] / 255.0f;
+        }
+        dst[i * 4 + 3] = texels[i * 4 + 3] / 255.0f;
+    }
+}
+
+void encodeLayer(const float* src, size_t texelCount, bool srgb, uint8_t* texels) {
+    const std::array<uint8_t, linearSteps>& toSrgb = linearToSrgb();
+
+    for (size_t i = 0; i < texelCount; i++) {
+        for (size_t c = 0; c < 3; c++) {
+            float value = std::min(std::max(src[i * 4 + c], 0.0f), 1.0f);
+            texels[i * 4 + c] =
+                srgb ? toSrgb[static_cast<uint32_t>(value * (linearSteps - 1) + 0.5f)]
+                     : static_cast<uint8_t>(value * 255.0f + 0.5f);
+        }
+        float alpha = std::min(std::max(src[i * 4 + 3], 0.0f), 1.0f);
+        texels[i * 4 + 3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+    }
+}
+
+// Layers of width * height texels laid out side by side in a larger image, texPerRow of them to
+// each row of layers.
+struct LayerSource {
+    const uint8_t* texels;
+    uint32_t texWidth;
+    uint32_t texPerRow;
+    uint32_t width;
+    uint32_t height;
+
+    const uint8_t* getRow(uint32_t layer, uint32_t row) const {
+        uint32_t xLayer = layer % texPerRow;
+        uint32_t yLayer = layer / texPerRow;
+        size_t texel = static_cast<size_t>(yLayer * height + row) * texWidth + xLayer * width;
+
+        return texels + texel * 4;
+    }
+};
+
+LayerSource getLayerSource(const uint8_t* texels, uint32_t texWidth, uint32_t texHeight,
+                           uint32_t width, uint32_t height, uint32_t layerCount) {
+    uint32_t texPerRow = width == 0 ? 0 : texWidth / width;
+    if (texPerRow == 0 || (layerCount + texPerRow - 1) / texPerRow * height > texHeight) {
+        throw std::runtime_error("Texture layers don't fit in the texture image!");
+    }
+
+    return LayerSource{texels, texWidth, texPerRow, width, height};
+}
+
+// Writes the layers one after the other, the layout of the first level.
+void copyLayers(const LayerSource& source, uint32_t layerCount, uint8_t* dst) {
+    size_t rowByteSize = static_cast<size_t>(source.width) * 4;
+
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        for (uint32_t row = 0; row < source.height; row++) {
+            memcpy(dst, source.getRow(layer, row), rowByteSize);
+            dst += rowByteSize;
+        }
+    }
+}
+
+// Hashed row by row in the order copyLayers writes them, so it matches hashing the first level.
+uint64_t hashLayers(const LayerSource& source, uint32_t layerCount, uint32_t levelCount,
+                    bool srgb) {
+    uint32_t parameters[5] = {source.width, source.height, layerCount, levelCount,
+                              srgb ? 1u : 0u};
+
+    uint64_t value = fnv1a(fnvOffsetBasis, parameters, sizeof(parameters));
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        for (uint32_t row = 0; row < source.height; row++) {
+            value = fnv1a(value, source.getRow(layer, row), static_cast<size_t>(source.width) * 4);
+        }
+    }
+
+    return value;
+}
+
+// Averages 2x2 source texels into each destination texel. A source that is only one texel wide or
+// high is sampled twice, and the last row or column of an odd sized source is dropped, like a blit.
+// The loops are kept free of branches on the channels so the compiler can vectorize them.
+void downsample(const float* src, uint32_t srcWidth, uint32_t srcHeight, float* dst,
+                uint32_t dstWidth, uint32_t dstHeight) {
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        const float* row0 =
+            src + static_cast<size_t>(std::min(y * 2, srcHeight - 1)) * srcWidth * 4;
+        const float* row1 =
+            src + static_cast<size_t>(std::min(y * 2 + 1, srcHeight - 1)) * srcWidth * 4;
+        float* dstRow = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            size_t x0 = std::min(x * 2, srcWidth - 1) * 4;
+            size_t x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+
+            for (size_t c = 0; c < 4; c++) {
+                dstRow[x * 4 + c] =
+                    (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+            }
+        }
+    }
+}
+
+// Writes every level after the first to mips, the start of the second level. Each layer is decoded
+// to linear floats once and stays in floats all the way down, so the small levels don't pile up
+// rounding errors from the ones above them. mips is only written, never read.
+void generateLevels(const LayerSource& source, uint32_t layerCount,
+                    const std::vector<TextureLevel>& levels, bool srgb, uint8_t* mips) {
+    size_t baseTexelCount = static_cast<size_t>(source.width) * source.height;
+    std::vector<float> current(baseTexelCount * 4);
+    std::vector<float> next(baseTexelCount * 4);
+
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        for (uint32_t row = 0; row < source.height; row++) {
+            decodeLayer(source.getRow(layer, row), source.width, srgb,
+                        current.data() + static_cast<size_t>(row) * source.width * 4);
+        }
+
+        for (size_t i = 1; i < levels.size(); i++) {
+            const TextureLevel& sourceLevel = levels[i - 1];
+            const TextureLevel& level = levels[i];
+            size_t texelCount = static_cast<size_t>(level.width) * level.height;
+
+            downsample(current.data(), sourceLevel.width, sourceLevel.height, next.data(),
+                       level.width, level.height);
+            encodeLayer(next.data(), texelCount, srgb,
+                        mips + (level.offset - levels[1].offset) + layer * texelCount * 4);
+
+            current.swap(next);
+        }
+    }
+}
+
+} // namespace
+
+void MipCache::create(const std::string& directory) {
+    this->directory = directory;
+
+    // A directory that can't be created only means nothing gets saved.
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+}
+
+void MipCache::destroy() { directory.clear(); }
+
+bool MipCache::load(uint64_t key, uint8_t* dst, size_t byteSize) const {
+    std::ifstream file(getPath(key), std::ios::binary);
+
+    // A missing file just means the chain hasn't been cached yet.
+    if (!file.is_open())
+        return false;
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file || header.magic != cacheMagic || header.version != cacheVersion ||
+        header.key != key || header.byteSize != byteSize)
+        return false;
+
+    file.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(byteSize));
+
+    return static_cast<bool>(file);
+}
+
+void MipCache::store(uint64_t key, const uint8_t* data, size_t byteSize) const {
+    CacheHeader header{cacheMagic, cacheVersion, key, byteSize};
+    std::string path = getPath(key);
+
+    // Written to a temporary file first so a crash mid-write can't leave a truncated chain. The
+    // thread is part of the name because two threads may be saving the same texture.
+    std::string tempPath =
+        path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+        ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(byteSize));
+        file.close();
+
+        if (!file) {
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+
+    if (error) {
+        std::remove(tempPath.c_str());
+    }
+}
+
+std::string MipCache::getPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.mips", static_cast<unsigned long long>(key));
+
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::vector<TextureLevel> MipChain::layout(uint32_t width, uint32_t height, uint32_t layerCount,
+                                           uint32_t levelCount) {
+    std::vector<TextureLevel> levels(levelCount);
+
+    size_t offset = 0;
+    for (uint32_t i = 0; i < levelCount; i++) {
+        TextureLevel& level = levels[i];
+        level.width = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+        level.offset = offset;
+        level.byteSize = static_cast<size_t>(level.width) * level.height * 4 * layerCount;
+        offset += level.byteSize;
+    }
+
+    return levels;
+}
+
+MipChain MipChain::build(const uint8_t* texels, uint32_t texWidth, uint32_t texHeight,
+                         uint32_t width, uint32_t height, uint32_t layerCount, uint32_t levelCount,
+                         bool srgb, const MipCache* mipCache) {
+    MipChain chain;
+    chain.width = width;
+    chain.height = height;
+    chain.layerCount = layerCount;
+    chain.srgb = srgb;
+    chain.levels = layout(width, height, layerCount, levelCount);
+
+    const TextureLevel& lastLevel = chain.levels.back();
+    chain.data.resize(lastLevel.offset + lastLevel.byteSize);
+
+    buildInto(texels, texWidth, texHeight, width, height, layerCount, levelCount, srgb,
+              chain.data.data(), mipCache);
+
+    return chain;
+}
+
+void MipChain::buildInto(const uint8_t* texels, uint32_t texWidth, uint32_t texHeight,
+                         uint32_t width, uint32_t height, uint32_t layerCount, uint32_t levelCount,
+                         bool srgb, uint8_t* dst, const MipCache* mipCache) {
+    LayerSource source = getLayerSource(texels, texWidth, texHeight, width, height, layerCount);
+    copyLayers(source, layerCount, dst);
+
+    if (levelCount == 1)
+        return;
+
+    std::vector<TextureLevel> levels = layout(width, height, layerCount, levelCount);
+    uint8_t* mips = dst + levels[1].offset;
+    size_t mipByteSize = levels.back().offset + levels.back().byteSize - levels[1].offset;
+
+    if (mipCache == nullptr) {
+        generateLevels(source, layerCount, levels, srgb, mips);
+        return;
+    }
+
+    uint64_t key = hashLayers(source, layerCount, levelCount, srgb);
+    if (mipCache->load(key, mips, mipByteSize))
+        return;
+
+    // Saving reads the levels back, which dst may be too slow for, so they are generated into
+    // ordinary memory first.
+    std::vector<uint8_t> generated(mipByteSize);
+    generateLevels(source, layerCount, levels, srgb, generated.data());
+    mipCache->store(key, generated.data(), mipByteSize);
+    memcpy(mips, generated.data(), mipByteSize);
+}
+
+void MipChain::generate() {
+    if (levels.size() < 2)
+        return;
+
+    LayerSource source{data.data(), width, 1, width, height};
+    generateLevels(source, layerCount, levels, srgb, data.data() + levels[1].offset);
+}
+
+uint64_t MipChain::hash() const {
+    LayerSource source{data.data(), width, 1, width, height};
+    return hashLayers(source, layerCount, static_cast<uint32_t>(levels.size()), srgb);
+}
+
+uint32_t MipChain::getWidth() const { return width; }
+
+uint32_t MipChain::getHeight() const { return height; }
+
+uint32_t MipChain::getLayerCount() const { return layerCount; }
+
+const std::vector<TextureLevel>& MipChain::getLevels() const { return levels; }
+
+const std::vector<uint8_t>& MipChain::getData() const { return data; }
\ No newline at end of file
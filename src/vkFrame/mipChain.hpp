@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compressedTexture.hpp"
+
+/*
+ * A directory of mip chains generated by earlier runs, each file named after a hash of the texels
+ * it was generated from, so an edited texture never picks up a stale chain.
+ */
+class MipCache {
+public:
+    // Creates the directory if it doesn't exist yet.
+    void create(const std::string& directory);
+    void destroy();
+
+    // Reads the levels saved under key into dst, false if there aren't byteSize of them. Safe to
+    // call from several threads at once, as is store.
+    bool load(uint64_t key, uint8_t* dst, size_t byteSize) const;
+    // Failing to save isn't an error, the chain will just be generated again next time.
+    void store(uint64_t key, const uint8_t* data, size_t byteSize) const;
+
+private:
+    std::string getPath(uint64_t key) const;
+
+    std::string directory;
+};
+
+/*
+ * Every mip level of an RGBA8 texture or texture array, generated on the CPU with a box filter
+ * that averages sRGB texels in linear space. Unlike blitting on the GPU this doesn't need the
+ * format to support linear blits, and the levels can be uploaded with a single copy.
+ */
+class MipChain {
+public:
+    // Lays out levelCount levels of layerCount width * height layers, each level holding all of
+    // its layers one after the other, like CompressedTexture.
+    static std::vector<TextureLevel> layout(uint32_t width, uint32_t height, uint32_t layerCount,
+                                            uint32_t levelCount);
+    // Cuts layerCount width * height layers out of texels, row by row like
+    // Image::createTextureArray, into the first level. The other levels come from mipCache, or
+    // are generated and saved there when it doesn't have them. Without a cache they are always
+    // generated.
+    static MipChain build(const uint8_t* texels, uint32_t texWidth, uint32_t texHeight,
+                          uint32_t width, uint32_t height, uint32_t layerCount,
+                          uint32_t levelCount, bool srgb, const MipCache* mipCache = nullptr);
+    // Builds the same levels straight into dst, laid out by layout. dst is only written, so it can
+    // be write combined memory like the staging ring.
+    static void buildInto(const uint8_t* texels, uint32_t texWidth, uint32_t texHeight,
+                          uint32_t width, uint32_t height, uint32_t layerCount,
+                          uint32_t levelCount, bool srgb, uint8_t* dst,
+                          const MipCache* mipCache = nullptr);
+
+    // Downsamples every level after the first from the one before it.
+    void generate();
+    // Hash of the dimensions and the first level, the key the chain is cached under.
+    uint64_t hash() const;
+
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getLayerCount() const;
+    const std::vector<TextureLevel>& getLevels() const;
+    const std::vector<uint8_t>& getData() const;
+
+private:
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t layerCount = 1;
+    bool srgb = true;
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+};
\ No newline at end of file
@@ -1,92 +1,350 @@
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 
+// Meshes live in the geometry arena the model is created with, so models with the same index type
+// can share one bind. instanceCapacity is only where instance storage starts out, updateInstances
+// grows it as needed.
 template <typename V, typename I, typename D> class Model {
+    static_assert(sizeof(I) == 2 || sizeof(I) == 4, "Indices should be 16 or 32 bit!");
+
 public:
     static Model<V, I, D> fromVerticesAndIndices(const std::vector<V>& vertices,
                                                  const std::vector<I> indices,
-                                                 const size_t maxInstances, VmaAllocator allocator,
-                                                 Commands& commands, VkQueue graphicsQueue,
-                                                 VkDevice device) {
-        Model model = create(maxInstances, allocator, commands, graphicsQueue, device);
-        model.size = indices.size();
-
-        model.indexBuffer =
-            Buffer::fromIndices(allocator, commands, graphicsQueue, device, indices);
-        model.vertexBuffer =
-            Buffer::fromVertices(allocator, commands, graphicsQueue, device, vertices);
+                                                 const size_t instanceCapacity,
+                                                 const uint32_t maxFramesInFlight,
+                                                 GeometryArena& geometryArena,
+                                                 VmaAllocator allocator, Commands& commands,
+                                                 VkQueue graphicsQueue, VkDevice device) {
+        UploadBatch batch;
+        batch.begin(allocator, commands, graphicsQueue, device, geometryArena.getMemoryBudget());
+        Model model = fromVerticesAndIndices(vertices, indices, instanceCapacity,
+                                             maxFramesInFlight, geometryArena, batch);
+        batch.submit();
+        batch.wait();
 
         return model;
     }
 
-    static Model<V, I, D> create(const size_t maxInstances, VmaAllocator allocator,
-                                 Commands& commands, VkQueue graphicsQueue, VkDevice device) {
+    // Records the uploads into batch, the model can't be drawn until the batch has been submitted.
+    static Model<V, I, D> fromVerticesAndIndices(const std::vector<V>& vertices,
+                                                 const std::vector<I> indices,
+                                                 const size_t instanceCapacity,
+                                                 const uint32_t maxFramesInFlight,
+                                                 GeometryArena& geometryArena,
+                                                 UploadBatch& batch) {
         Model model;
+        model.geometryArena = &geometryArena;
+        model.createInstanceBuffers(instanceCapacity, maxFramesInFlight, batch.getAllocator());
+        model.uploadMesh(vertices, indices, batch);
 
-        size_t instanceByteSize = maxInstances * sizeof(D);
-        model.instanceStagingBuffer =
-            Buffer(allocator, instanceByteSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, true);
-        model.instanceBuffer =
-            Buffer(allocator, instanceByteSize,
-                   VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, false);
+        return model;
+    }
+
+    static Model<V, I, D> create(const size_t instanceCapacity, const uint32_t maxFramesInFlight,
+                                 GeometryArena& geometryArena, VmaAllocator allocator) {
+        Model model;
+        model.geometryArena = &geometryArena;
+        model.createInstanceBuffers(instanceCapacity, maxFramesInFlight, allocator);
 
         return model;
     };
 
     void draw(VkCommandBuffer commandBuffer) {
-        if (vertexBuffer.getSize() == 0 || instanceBuffer.getSize() == 0 ||
-            indexBuffer.getSize() == 0)
+        if (geometryArena == nullptr)
             return;
 
-        if (instanceCount < 1)
+        geometryArena->bind(commandBuffer, getIndexType());
+        drawBound(commandBuffer);
+    }
+
+    // Draws without binding the geometry arena. Bind it once with GeometryArena::bind, then draw
+    // any number of models that use the same index type.
+    void drawBound(VkCommandBuffer commandBuffer) {
+        if (vertexRange.size == 0 || indexRange.size == 0)
             return;
 
-        VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+        if (instanceCount < 1)
+            return;
 
-        if (sizeof(I) == 4)
-            indexType = VK_INDEX_TYPE_UINT32;
+        Buffer& instanceBuffer = instanceBuffers[currentInstanceBuffer];
+        // The buffer is read by the frame being recorded, whose value was reserved when it was
+        // acquired.
+        instanceTimelineValues[currentInstanceBuffer] = frameTimeline->getReservedValue();
 
         VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.getBuffer(), offsets);
         vkCmdBindVertexBuffers(commandBuffer, 1, 1, &instanceBuffer.getBuffer(), offsets);
-        vkCmdBindIndexBuffer(commandBuffer, indexBuffer.getBuffer(), 0, indexType);
         vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(size),
-                         static_cast<uint32_t>(instanceCount), 0, 0, 0);
+                         static_cast<uint32_t>(instanceCount),
+                         static_cast<uint32_t>(indexRange.offset / sizeof(I)),
+                         static_cast<int32_t>(vertexRange.offset / sizeof(V)), 0);
     }
 
+    static VkIndexType getIndexType() {
+        return sizeof(I) == 4 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+    }
+
+    // Frames in flight keep drawing the old mesh, its ranges are retired rather than freed.
+    // Nothing waits, frames submitted afterwards draw the new mesh once its upload completes. If
+    // the upload fails the model keeps the old mesh.
     void update(const std::vector<V>& vertices, const std::vector<I>& indices, Commands& commands,
-                VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device) {
-        size = indices.size();
+                VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device,
+                DeletionQueue& deletionQueue) {
+        if (geometryArena == nullptr) {
+            throw std::runtime_error("Model has no geometry arena to upload its mesh to!");
+        }
+
+        GeometryRange oldVertexRange = vertexRange;
+        GeometryRange oldIndexRange = indexRange;
 
-        vkDeviceWaitIdle(device);
+        UploadBatch batch;
+        batch.begin(allocator, commands, graphicsQueue, device, geometryArena->getMemoryBudget());
+        uploadMesh(vertices, indices, batch);
+        batch.submit();
 
-        indexBuffer.destroy(allocator);
-        vertexBuffer.destroy(allocator);
+        retireRanges(deletionQueue, oldVertexRange, oldIndexRange);
+        vertexUpdates.clear();
+        indexUpdates.clear();
+    }
+
+    // Replaces vertices in place, starting at firstVertex. Only the changed bytes are uploaded,
+    // once recordUpdates is called.
+    void updateVertices(const size_t firstVertex, const std::vector<V>& vertices) {
+        VkDeviceSize offset = firstVertex * sizeof(V);
+        VkDeviceSize byteSize = vertices.size() * sizeof(V);
+        if (offset + byteSize > vertexRange.size) {
+            throw std::runtime_error("Vertex update is out of the model's range!");
+        }
+
+        vertexUpdates.write(vertexRange.offset + offset, vertices.data(), byteSize);
+    }
+
+    void updateIndices(const size_t firstIndex, const std::vector<I>& indices) {
+        VkDeviceSize offset = firstIndex * sizeof(I);
+        VkDeviceSize byteSize = indices.size() * sizeof(I);
+        if (offset + byteSize > indexRange.size) {
+            throw std::runtime_error("Index update is out of the model's range!");
+        }
 
-        indexBuffer = Buffer::fromIndices(allocator, commands, graphicsQueue, device, indices);
-        vertexBuffer = Buffer::fromVertices(allocator, commands, graphicsQueue, device, vertices);
+        indexUpdates.write(indexRange.offset + offset, indices.data(), byteSize);
     }
 
+    // Records the vertex and index updates made since the last call as one copy per buffer,
+    // coalescing adjacent ranges. Call with the frame's command buffer outside a render pass,
+    // before the model is drawn.
+    void recordUpdates(VkCommandBuffer commandBuffer, Commands& commands, VmaAllocator allocator) {
+        if (vertexUpdates.empty() && indexUpdates.empty())
+            return;
+
+        // Earlier frames may still be reading the ranges being overwritten.
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0,
+                             nullptr);
+
+        StagingRing& stagingRing = commands.getStagingRing();
+        vertexUpdates.record(commandBuffer, stagingRing, allocator,
+                             geometryArena->getVertexBuffer().getBuffer());
+        indexUpdates.record(commandBuffer, stagingRing, allocator,
+                            geometryArena->getIndexBuffer().getBuffer());
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0,
+                             nullptr);
+    }
+
+    // Writes straight into a mapped buffer without submitting anything. Each frame in flight has
+    // its own buffer, so this only waits if the GPU is a whole ring of frames behind. Buffers grow
+    // to fit any number of instances, and only the live instances are copied.
     void updateInstances(const std::vector<D>& instances, Commands& commands,
-                         VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device) {
+                         VmaAllocator allocator) {
+        instanceData.assign(instances.begin(), instances.end());
         instanceCount = instances.size();
-        instanceStagingBuffer.setData(instances.data());
-        instanceStagingBuffer.copyTo(allocator, graphicsQueue, device, commands, instanceBuffer);
+
+        markInstancesDirty(0, instanceCount);
+        writeInstances(commands, allocator);
+    }
+
+    // Replaces instances in place, starting at firstInstance. Each frame in flight's buffer only
+    // has the instances that changed since it was last written copied into it.
+    void updateInstances(const size_t firstInstance, const std::vector<D>& instances,
+                         Commands& commands, VmaAllocator allocator) {
+        if (firstInstance + instances.size() > instanceCount) {
+            throw std::runtime_error("Instance update is out of the model's range!");
+        }
+
+        std::copy(instances.begin(), instances.end(), instanceData.begin() + firstInstance);
+
+        markInstancesDirty(firstInstance, instances.size());
+        writeInstances(commands, allocator);
     }
 
     void destroy(VmaAllocator allocator) {
-        vertexBuffer.destroy(allocator);
-        indexBuffer.destroy(allocator);
-        instanceStagingBuffer.destroy(allocator);
-        instanceBuffer.destroy(allocator);
+        if (geometryArena != nullptr) {
+            geometryArena->freeVertices(vertexRange);
+            geometryArena->freeIndices(indexRange);
+            geometryArena = nullptr;
+            vertexRange = GeometryRange{};
+            indexRange = GeometryRange{};
+        }
+
+        for (Buffer& instanceBuffer : instanceBuffers) {
+            instanceBuffer.destroy(allocator);
+        }
+    }
+
+    void retire(VmaAllocator allocator, DeletionQueue& deletionQueue) {
+        retireMesh(deletionQueue);
+        geometryArena = nullptr;
+
+        for (Buffer& instanceBuffer : instanceBuffers) {
+            instanceBuffer.retire(allocator, deletionQueue);
+        }
     }
 
 private:
-    Buffer vertexBuffer;
-    Buffer indexBuffer;
-    Buffer instanceBuffer;
-    Buffer instanceStagingBuffer;
+    // The model only takes the new ranges once everything has been recorded, if anything throws
+    // they are freed and the model keeps the ranges it had.
+    void uploadMesh(const std::vector<V>& vertices, const std::vector<I>& indices,
+                    UploadBatch& batch) {
+        GeometryRange newVertexRange =
+            geometryArena->allocateVertices(sizeof(V) * vertices.size(), sizeof(V));
+        GeometryRange newIndexRange;
+
+        try {
+            newIndexRange = geometryArena->allocateIndices(sizeof(I) * indices.size(), sizeof(I));
+
+            VkCommandBuffer commandBuffer = batch.getCommandBuffer();
+            if (newVertexRange.size != 0) {
+                StagingAllocation staging = batch.stage(vertices.data(), newVertexRange.size);
+                geometryArena->getVertexBuffer().copyFromStaging(commandBuffer, staging,
+                                                                 newVertexRange.offset);
+            }
+
+            if (newIndexRange.size != 0) {
+                StagingAllocation staging = batch.stage(indices.data(), newIndexRange.size);
+                geometryArena->getIndexBuffer().copyFromStaging(commandBuffer, staging,
+                                                                newIndexRange.offset);
+            }
+        } catch (...) {
+            geometryArena->freeVertices(newVertexRange);
+            geometryArena->freeIndices(newIndexRange);
+            throw;
+        }
+
+        size = indices.size();
+        vertexRange = newVertexRange;
+        indexRange = newIndexRange;
+    }
+
+    void retireMesh(DeletionQueue& deletionQueue) {
+        retireRanges(deletionQueue, vertexRange, indexRange);
+        vertexRange = GeometryRange{};
+        indexRange = GeometryRange{};
+    }
+
+    void retireRanges(DeletionQueue& deletionQueue, const GeometryRange& retiredVertexRange,
+                      const GeometryRange& retiredIndexRange) {
+        if (geometryArena == nullptr ||
+            (retiredVertexRange.size == 0 && retiredIndexRange.size == 0))
+            return;
+
+        deletionQueue.push([geometryArena = geometryArena, retiredVertexRange,
+                            retiredIndexRange] {
+            geometryArena->freeVertices(retiredVertexRange);
+            geometryArena->freeIndices(retiredIndexRange);
+        });
+    }
+
+    void markInstancesDirty(const size_t firstInstance, const size_t count) {
+        for (DirtyRanges& dirtyRanges : instanceDirtyRanges) {
+            dirtyRanges.add(firstInstance * sizeof(D), count * sizeof(D));
+        }
+    }
+
+    void writeInstances(Commands& commands, VmaAllocator allocator) {
+        frameTimeline = &commands.getFrameTimeline();
+
+        // A buffer the GPU is done with can be overwritten, otherwise move on to the next one.
+        uint64_t lastSubmittedValue = frameTimeline->getLastSubmittedValue();
+        uint64_t currentValue = instanceTimelineValues[currentInstanceBuffer];
+        if (currentValue > lastSubmittedValue || !frameTimeline->isComplete(currentValue)) {
+            currentInstanceBuffer = (currentInstanceBuffer + 1) % instanceBuffers.size();
+
+            uint64_t nextValue = instanceTimelineValues[currentInstanceBuffer];
+            if (nextValue > lastSubmittedValue) {
+                throw std::runtime_error(
+                    "Model instances were updated more often than once per frame in flight!");
+            }
+
+            frameTimeline->wait(nextValue);
+        }
+
+        VkDeviceSize liveByteSize = instanceCount * sizeof(D);
+        Buffer& instanceBuffer = instanceBuffers[currentInstanceBuffer];
+        DirtyRanges& dirtyRanges = instanceDirtyRanges[currentInstanceBuffer];
+
+        if (liveByteSize > instanceBuffer.getSize()) {
+            // Doubling keeps reallocations rare as counts creep up. The GPU is done with this
+            // buffer, that was checked above, so it can be released straight away.
+            size_t capacity = std::max(instanceBuffer.getSize() / sizeof(D) * 2, instanceCount);
+            instanceBuffer.destroy(allocator);
+            instanceBuffer = Buffer(allocator, capacity * sizeof(D),
+                                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, true,
+                                    geometryArena->getMemoryBudget());
+
+            dirtyRanges.clear();
+            dirtyRanges.add(0, liveByteSize);
+        }
+
+        const char* data = reinterpret_cast<const char*>(instanceData.data());
+        for (const DirtyRange& range : dirtyRanges.coalesce()) {
+            // Ranges past the live instances were dropped by a smaller full update.
+            if (range.offset >= liveByteSize)
+                break;
+
+            VkDeviceSize size = std::min(range.size, liveByteSize - range.offset);
+            instanceBuffer.setData(data + range.offset, size, range.offset);
+            instanceBuffer.flush(allocator, range.offset, size);
+        }
+
+        dirtyRanges.clear();
+    }
+
+    void createInstanceBuffers(const size_t instanceCapacity, const uint32_t maxFramesInFlight,
+                               VmaAllocator allocator) {
+        // Host visible memory is device local where the device has it (ReBAR or unified memory),
+        // otherwise the GPU reads the instances from host memory directly.
+        size_t instanceByteSize = instanceCapacity * sizeof(D);
+        instanceBuffers.resize(maxFramesInFlight);
+        for (Buffer& instanceBuffer : instanceBuffers) {
+            instanceBuffer = Buffer(allocator, instanceByteSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                    true, geometryArena->getMemoryBudget());
+        }
+
+        // Zero is the timeline's initial value, so buffers that were never drawn never wait.
+        instanceTimelineValues.assign(maxFramesInFlight, 0);
+        instanceDirtyRanges.resize(maxFramesInFlight);
+    }
+
+    GeometryArena* geometryArena = nullptr;
+    GeometryRange vertexRange;
+    GeometryRange indexRange;
+    BufferUpdates vertexUpdates;
+    BufferUpdates indexUpdates;
+    // One per frame in flight, tagged with the frame timeline value of the last frame to draw it.
+    std::vector<Buffer> instanceBuffers;
+    std::vector<uint64_t> instanceTimelineValues;
+    // What has changed since each buffer was last written, copied from instanceData.
+    std::vector<DirtyRanges> instanceDirtyRanges;
+    std::vector<D> instanceData;
+    size_t currentInstanceBuffer = 0;
+    Timeline* frameTimeline = nullptr;
     size_t size = 0;
     size_t instanceCount = 0;
 };
\ No newline at end of file
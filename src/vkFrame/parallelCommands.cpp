@@ -0,0 +1,99 @@
+#include "parallelCommands.hpp"
+
+void ParallelCommands::create(VkDevice device, const QueueFamilyIndices& queueFamilyIndices,
+                              uint32_t maxFramesInFlight, WorkerPool& workerPool) {
+    this->device = device;
+    this->workerPool = &workerPool;
+    workerCount = workerPool.getWorkerCount();
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+    workerFrames.resize(maxFramesInFlight * workerCount);
+
+    for (WorkerFrame& workerFrame : workerFrames) {
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &workerFrame.pool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create worker command pool!");
+        }
+    }
+}
+
+void ParallelCommands::reserve(uint32_t taskCount) {
+    // Any one worker might end up recording every task.
+    for (WorkerFrame& workerFrame : workerFrames) {
+        allocateBuffers(workerFrame, taskCount);
+    }
+
+    if (recordedBuffers.size() < taskCount) {
+        recordedBuffers.resize(taskCount);
+    }
+}
+
+void ParallelCommands::beginFrame(const uint32_t currentFrame) {
+    this->currentFrame = currentFrame;
+
+    // The frame's timeline value has been waited on, so none of its buffers are still in use.
+    for (uint32_t i = 0; i < workerCount; i++) {
+        WorkerFrame& workerFrame = workerFrames[currentFrame * workerCount + i];
+        vkResetCommandPool(device, workerFrame.pool, 0);
+        workerFrame.usedBuffers = 0;
+    }
+}
+
+void ParallelCommands::allocateBuffers(WorkerFrame& workerFrame, size_t bufferCount) {
+    if (workerFrame.buffers.size() >= bufferCount)
+        return;
+
+    size_t firstBuffer = workerFrame.buffers.size();
+    workerFrame.buffers.resize(bufferCount);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = workerFrame.pool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = static_cast<uint32_t>(bufferCount - firstBuffer);
+
+    if (vkAllocateCommandBuffers(device, &allocInfo, workerFrame.buffers.data() + firstBuffer) !=
+        VK_SUCCESS) {
+        workerFrame.buffers.resize(firstBuffer);
+        throw std::runtime_error("Failed to allocate secondary command buffer!");
+    }
+}
+
+VkCommandBuffer
+ParallelCommands::beginSecondary(uint32_t workerIndex,
+                                 const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+    WorkerFrame& workerFrame = workerFrames[currentFrame * workerCount + workerIndex];
+
+    // Buffers are kept after the pool is reset, new ones are only needed when a worker records
+    // more tasks in a frame than it ever has before.
+    allocateBuffers(workerFrame, workerFrame.usedBuffers + 1);
+
+    VkCommandBuffer commandBuffer = workerFrame.buffers[workerFrame.usedBuffers];
+    workerFrame.usedBuffers++;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording secondary command buffer!");
+    }
+
+    return commandBuffer;
+}
+
+uint32_t ParallelCommands::getWorkerCount() { return workerCount; }
+
+void ParallelCommands::destroy(VkDevice device) {
+    for (WorkerFrame& workerFrame : workerFrames) {
+        vkDestroyCommandPool(device, workerFrame.pool, nullptr);
+    }
+
+    workerFrames.clear();
+    recordedBuffers.clear();
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "queueFamilyIndices.hpp"
+#include "renderPass.hpp"
+#include "workerPool.hpp"
+
+/*
+ * Records a render pass across a WorkerPool. Every worker gets its own command pool for each
+ * frame in flight, so recording never needs a lock, and the resulting secondary command buffers
+ * are executed in task order regardless of which worker recorded them.
+ */
+class ParallelCommands {
+public:
+    void create(VkDevice device, const QueueFamilyIndices& queueFamilyIndices,
+                uint32_t maxFramesInFlight, WorkerPool& workerPool);
+
+    // Allocates every buffer recording taskCount tasks per frame can need, however they end up
+    // spread across the workers, so that record never allocates afterwards.
+    void reserve(uint32_t taskCount);
+
+    // Resets the command pools of the current frame, call once per frame before recording.
+    void beginFrame(const uint32_t currentFrame);
+
+    // Calls recordTask(commandBuffer, taskIndex) for taskCount tasks spread across the workers,
+    // then executes the recorded buffers in order in the primary command buffer. The render pass
+    // must have been begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS.
+    template <typename F>
+    void record(VkCommandBuffer primaryBuffer, RenderPass& renderPass, const uint32_t imageIndex,
+                VkExtent2D extent, uint32_t taskCount, F& recordTask) {
+        if (taskCount == 0)
+            return;
+
+        // Only grows, so steady state recording doesn't allocate.
+        if (recordedBuffers.size() < taskCount) {
+            recordedBuffers.resize(taskCount);
+        }
+
+        VkCommandBufferInheritanceInfo inheritanceInfo = renderPass.getInheritanceInfo(imageIndex);
+
+        auto recordSecondary = [&](uint32_t taskIndex, uint32_t workerIndex) {
+            VkCommandBuffer commandBuffer = beginSecondary(workerIndex, inheritanceInfo);
+            renderPass.setViewport(commandBuffer, extent);
+
+            recordTask(commandBuffer, taskIndex);
+
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to record secondary command buffer!");
+            }
+
+            recordedBuffers[taskIndex] = commandBuffer;
+        };
+
+        workerPool->parallelFor(taskCount, recordSecondary);
+
+        vkCmdExecuteCommands(primaryBuffer, taskCount, recordedBuffers.data());
+    }
+
+    uint32_t getWorkerCount();
+
+    void destroy(VkDevice device);
+
+private:
+    struct WorkerFrame {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;
+        size_t usedBuffers = 0;
+    };
+
+    void allocateBuffers(WorkerFrame& workerFrame, size_t bufferCount);
+    VkCommandBuffer beginSecondary(uint32_t workerIndex,
+                                   const VkCommandBufferInheritanceInfo& inheritanceInfo);
+
+    VkDevice device = VK_NULL_HANDLE;
+    WorkerPool* workerPool = nullptr;
+    uint32_t workerCount = 0;
+    uint32_t currentFrame = 0;
+
+    // Indexed by frame * workerCount + worker.
+    std::vector<WorkerFrame> workerFrames;
+    std::vector<VkCommandBuffer> recordedBuffers;
+};
\ No newline at end of file
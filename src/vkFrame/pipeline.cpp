@@ -62,12 +62,28 @@ void Pipeline::createDescriptorSets(
     }
 }
 
+void Pipeline::updateDescriptorSet(uint32_t currentFrame) {
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    setupDescriptor(descriptorWrites, descriptorSets[currentFrame], currentFrame);
+}
+
 void Pipeline::bind(VkCommandBuffer commandBuffer, int32_t currentFrame) {
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
-                            &descriptorSets[currentFrame], 0, nullptr);
+    bind(commandBuffer, currentFrame, {});
+}
+
+void Pipeline::bind(VkCommandBuffer commandBuffer, int32_t currentFrame,
+                    std::initializer_list<uint32_t> dynamicOffsets) {
+    bindDescriptorSet(commandBuffer, currentFrame, dynamicOffsets);
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
 }
 
+void Pipeline::bindDescriptorSet(VkCommandBuffer commandBuffer, int32_t currentFrame,
+                                 std::initializer_list<uint32_t> dynamicOffsets) {
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                            &descriptorSets[currentFrame],
+                            static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.begin());
+}
+
 VkShaderModule Pipeline::createShaderModule(const std::vector<char>& code, VkDevice device) {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -100,9 +116,52 @@ std::vector<char> Pipeline::readFile(const std::string& filename) {
     return buffer;
 }
 
+bool Pipeline::isReady() {
+    if (!compiled.valid())
+        return true;
+
+    if (compiled.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    // Rethrows anything thrown while compiling.
+    compiled.get();
+    return true;
+}
+
+void Pipeline::waitUntilReady() {
+    if (compiled.valid()) {
+        compiled.get();
+    }
+}
+
+void Pipeline::setPipelineCache(PipelineCache* pipelineCache) {
+    this->pipelineCache = pipelineCache;
+}
+
 void Pipeline::cleanup(VkDevice device) {
+    // A failed compile leaves null handles behind, which are fine to destroy.
+    if (compiled.valid()) {
+        compiled.wait();
+    }
+
     vkDestroyPipeline(device, graphicsPipeline, nullptr);
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
     vkDestroyDescriptorPool(device, descriptorPool, nullptr);
     vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+
+void Pipeline::retire(VkDevice device, DeletionQueue& deletionQueue) {
+    if (compiled.valid()) {
+        compiled.wait();
+    }
+
+    // This allocates, but pipelines are only retired when they are rebuilt.
+    deletionQueue.push([device, graphicsPipeline = graphicsPipeline,
+                        pipelineLayout = pipelineLayout, descriptorPool = descriptorPool,
+                        descriptorSetLayout = descriptorSetLayout] {
+        vkDestroyPipeline(device, graphicsPipeline, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    });
 }
\ No newline at end of file
@@ -3,13 +3,19 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <chrono>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <vector>
 
+#include "pipelineCache.hpp"
 #include "renderPass.hpp"
 #include "swapchain.hpp"
+#include "workerPool.hpp"
 
 class Pipeline {
 public:
@@ -157,7 +163,10 @@ public:
         pipelineInfo.subpass = 0;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-        if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+        VkPipelineCache cache =
+            pipelineCache != nullptr ? pipelineCache->getCache() : VK_NULL_HANDLE;
+
+        if (vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo, nullptr,
                                       &graphicsPipeline) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create graphics pipeline!");
         }
@@ -183,9 +192,35 @@ public:
                            rasterizer);
     }
 
+    // Reads the shaders and compiles the pipeline on a worker thread instead of blocking. The
+    // descriptor set layout must already have been created, and the Pipeline must not be moved or
+    // bound until isReady returns true.
+    template <typename V, typename I>
+    void createAsync(const std::string& vertShader, const std::string& fragShader,
+                     VkDevice device, RenderPass& renderPass, bool enableTransparency,
+                     WorkerPool& workerPool) {
+        waitUntilReady();
+
+        auto compiledPromise = std::make_shared<std::promise<void>>();
+        compiled = compiledPromise->get_future();
+
+        workerPool.submit([=, &renderPass] {
+            try {
+                create<V, I>(vertShader, fragShader, device, renderPass, enableTransparency);
+                compiledPromise->set_value();
+            } catch (...) {
+                compiledPromise->set_exception(std::current_exception());
+            }
+        });
+    }
+
+    // The old pipeline and descriptors are retired through the deletion queue since frames in
+    // flight may still be using them.
     template <typename V, typename I>
-    void recreate(VkDevice device, const uint32_t maxFramesInFlight, RenderPass& renderPass) {
-        cleanup(device);
+    void recreate(VkDevice device, const uint32_t maxFramesInFlight, RenderPass& renderPass,
+                  DeletionQueue& deletionQueue) {
+        waitUntilReady();
+        retire(device, deletionQueue);
         createDescriptorSetLayout(device, setupBindings);
         createDescriptorPool(maxFramesInFlight, device, setupPool);
         createDescriptorSets(maxFramesInFlight, device, setupDescriptor);
@@ -202,16 +237,35 @@ public:
         const uint32_t maxFramesInFlight, VkDevice device,
         std::function<void(std::vector<VkWriteDescriptorSet>&, VkDescriptorSet, uint32_t)>
             setupDescriptor);
+    // Writes the frame's descriptor set again with the callback passed to createDescriptorSets,
+    // after a resource it refers to has been replaced. The frame's previous submission must have
+    // completed, as it has once the renderer has acquired the frame.
+    void updateDescriptorSet(uint32_t currentFrame);
     void cleanup(VkDevice device);
+    void retire(VkDevice device, DeletionQueue& deletionQueue);
 
     void bind(VkCommandBuffer commandBuffer, int32_t currentFrame);
+    // Offsets for the set's dynamic uniform buffers, in binding order.
+    void bind(VkCommandBuffer commandBuffer, int32_t currentFrame,
+              std::initializer_list<uint32_t> dynamicOffsets);
+    // Rebinds only the descriptor set, enough to switch dynamic offsets between draws.
+    void bindDescriptorSet(VkCommandBuffer commandBuffer, int32_t currentFrame,
+                           std::initializer_list<uint32_t> dynamicOffsets);
+
+    // Never blocks. Pipelines made with create are always ready, if compiling failed the error
+    // is thrown from here.
+    bool isReady();
+    void waitUntilReady();
+
+    // The cache create compiles through, pipelines are compiled from scratch without one.
+    void setPipelineCache(PipelineCache* pipelineCache);
 
 private:
     static VkShaderModule createShaderModule(const std::vector<char>& code, VkDevice device);
     static std::vector<char> readFile(const std::string& filename);
 
-    VkPipelineLayout pipelineLayout;
-    VkPipeline graphicsPipeline;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
 
     VkDescriptorSetLayout descriptorSetLayout;
     VkDescriptorPool descriptorPool;
@@ -226,4 +280,8 @@ private:
     std::string fragShader;
 
     bool transparencyEnabled = false;
+    PipelineCache* pipelineCache = nullptr;
+
+    // Only valid while a createAsync compile hasn't been waited on.
+    std::future<void> compiled;
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "pipelineCache.hpp"
+
+void PipelineCache::create(VkPhysicalDevice physicalDevice, VkDevice device,
+                           const std::string& path) {
+    this->path = path;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    std::vector<char> data = readFile();
+    if (!isCompatible(data)) {
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache!");
+    }
+}
+
+void PipelineCache::destroy(VkDevice device) {
+    if (cache == VK_NULL_HANDLE)
+        return;
+
+    writeFile(device);
+
+    vkDestroyPipelineCache(device, cache, nullptr);
+    cache = VK_NULL_HANDLE;
+}
+
+const VkPipelineCache& PipelineCache::getCache() { return cache; }
+
+bool PipelineCache::isCompatible(const std::vector<char>& data) {
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+        return false;
+
+    memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+           memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<char> PipelineCache::readFile() {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+
+    // A missing file just means nothing has been cached yet.
+    if (!file.is_open())
+        return {};
+
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> data(fileSize);
+
+    file.seekg(0);
+    file.read(data.data(), fileSize);
+
+    if (!file) {
+        data.clear();
+    }
+
+    return data;
+}
+
+void PipelineCache::writeFile(VkDevice device) {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+        return;
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS)
+        return;
+
+    // Writing to a temporary file first means a crash mid-write can't leave a truncated cache.
+    // Failing to save isn't an error, the next run will just compile its pipelines again.
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return;
+
+        file.write(data.data(), dataSize);
+        file.close();
+
+        if (!file) {
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+
+    if (error) {
+        std::remove(tempPath.c_str());
+    }
+}
\ No newline at end of file
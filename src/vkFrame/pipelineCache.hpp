@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * A VkPipelineCache shared by every Pipeline, loaded from disk when it is created and written back
+ * when it is destroyed, so pipelines compiled by an earlier run don't have to be compiled again.
+ */
+class PipelineCache {
+public:
+    // Data saved by a different driver or device is ignored and the cache starts out empty.
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path);
+    // Saves the cache, replacing the old file only once the new one has been fully written.
+    void destroy(VkDevice device);
+
+    const VkPipelineCache& getCache();
+
+private:
+    bool isCompatible(const std::vector<char>& data);
+    std::vector<char> readFile();
+    void writeFile(VkDevice device);
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties{};
+    std::string path;
+};
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "profiler.hpp"
+
+namespace {
+
+// Pass names come from the caller, so quotes, backslashes and control characters are escaped to
+// keep the trace valid JSON.
+void writeJsonString(std::ostream& output, const char* string) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    for (const char* c = string; *c != '\0'; c++) {
+        unsigned char value = static_cast<unsigned char>(*c);
+        if (value == '"' || value == '\\') {
+            output << '\\' << *c;
+        } else if (value < 0x20) {
+            output << "\\u00" << hexDigits[value >> 4] << hexDigits[value & 0xF];
+        } else {
+            output << *c;
+        }
+    }
+}
+
+} // namespace
+
+void Profiler::setEnabled(bool enabled) { this->enabled = enabled; }
+
+bool Profiler::isEnabled() { return enabled; }
+
+void Profiler::create(VkPhysicalDevice physicalDevice, VkDevice device,
+                      const QueueFamilyIndices& queueFamilyIndices, uint32_t maxFramesInFlight,
+                      uint32_t maxPassesPerFrame, uint32_t historySize) {
+    if (!enabled)
+        return;
+
+    this->device = device;
+    this->maxPassesPerFrame = maxPassesPerFrame;
+    epoch = std::chrono::steady_clock::now();
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    timestampPeriod = properties.limits.timestampPeriod;
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                             queueFamilies.data());
+
+    uint32_t graphicsFamily = queueFamilyIndices.graphicsFamily.value();
+    uint32_t validBits = queueFamilies[graphicsFamily].timestampValidBits;
+    gpuTimingSupported = properties.limits.timestampComputeAndGraphics && validBits > 0;
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    slots.resize(maxFramesInFlight);
+
+    if (gpuTimingSupported) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = maxPassesPerFrame * 2;
+
+        for (FrameSlot& slot : slots) {
+            if (vkCreateQueryPool(device, &poolInfo, nullptr, &slot.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create timestamp query pool!");
+            }
+        }
+    }
+
+    // Each query reads back as a value followed by its availability.
+    queryResults.resize(maxPassesPerFrame * 2 * 2);
+
+    history.resize(historySize);
+    for (FrameProfile& profile : history) {
+        profile.passes.resize(maxPassesPerFrame);
+    }
+
+    created = true;
+}
+
+void Profiler::destroy(VkDevice device) {
+    if (!created)
+        return;
+
+    for (FrameSlot& slot : slots) {
+        if (slot.queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, slot.queryPool, nullptr);
+        }
+    }
+
+    slots.clear();
+    created = false;
+}
+
+void Profiler::beginFrame(uint32_t currentFrame) {
+    if (!created)
+        return;
+
+    // Pick up any results that are already available, this never blocks.
+    for (FrameSlot& slot : slots) {
+        if (slot.pending) {
+            collect(slot, false);
+        }
+    }
+
+    currentSlot = &slots[currentFrame];
+    currentSlot->poolReset = false;
+    passOpen = false;
+
+    FrameProfile& profile = history[frameCount % history.size()];
+    profile.frameNumber = frameCount;
+    profile.cpuPhaseStarts.fill(0.0);
+    profile.cpuPhaseMilliseconds.fill(0.0);
+    profile.cpuStart = now();
+    profile.cpuMilliseconds = 0.0;
+    profile.passCount = 0;
+    profile.gpuMilliseconds = 0.0;
+    profile.gpuValid = false;
+}
+
+void Profiler::endFrame() {
+    if (!created)
+        return;
+
+    FrameProfile& profile = history[frameCount % history.size()];
+    profile.cpuMilliseconds = now() - profile.cpuStart;
+
+    if (!gpuTimingSupported || profile.passCount == 0) {
+        latestFrame = frameCount;
+        hasLatest = true;
+    }
+
+    currentSlot = nullptr;
+    frameCount++;
+}
+
+void Profiler::beginPhase(CpuPhase phase) {
+    if (!created)
+        return;
+
+    FrameProfile& profile = history[frameCount % history.size()];
+    profile.cpuPhaseStarts[static_cast<size_t>(phase)] = now();
+}
+
+void Profiler::endPhase(CpuPhase phase) {
+    if (!created)
+        return;
+
+    FrameProfile& profile = history[frameCount % history.size()];
+    size_t i = static_cast<size_t>(phase);
+    profile.cpuPhaseMilliseconds[i] = now() - profile.cpuPhaseStarts[i];
+}
+
+void Profiler::beginPass(VkCommandBuffer commandBuffer, const std::string& name) {
+    if (!created || currentSlot == nullptr)
+        return;
+
+    FrameProfile& profile = history[frameCount % history.size()];
+
+    // Passes beyond the query pool's capacity aren't timed.
+    passOpen = profile.passCount < maxPassesPerFrame;
+    if (!passOpen)
+        return;
+
+    std::string::size_type nameLength = std::min(name.size(), sizeof(PassTiming::name) - 1);
+    name.copy(profile.passes[profile.passCount].name, nameLength);
+    profile.passes[profile.passCount].name[nameLength] = '\0';
+
+    openPass = profile.passCount;
+    profile.passCount++;
+
+    if (!gpuTimingSupported)
+        return;
+
+    FrameSlot& slot = *currentSlot;
+
+    if (!slot.poolReset) {
+        // This frame's slot has been waited on by now, so the previous results are ready.
+        if (slot.pending) {
+            collect(slot, true);
+        }
+
+        vkCmdResetQueryPool(commandBuffer, slot.queryPool, 0, maxPassesPerFrame * 2);
+        slot.poolReset = true;
+        slot.frameNumber = frameCount;
+        slot.passCount = 0;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.queryPool,
+                        openPass * 2);
+}
+
+void Profiler::endPass(VkCommandBuffer commandBuffer) {
+    if (!created || currentSlot == nullptr || !passOpen)
+        return;
+
+    passOpen = false;
+    if (!gpuTimingSupported || !currentSlot->poolReset)
+        return;
+
+    FrameSlot& slot = *currentSlot;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.queryPool,
+                        openPass * 2 + 1);
+    slot.passCount = openPass + 1;
+    slot.pending = true;
+}
+
+void Profiler::collectPending() {
+    if (!created)
+        return;
+
+    for (FrameSlot& slot : slots) {
+        if (slot.pending) {
+            collect(slot, true);
+        }
+    }
+}
+
+bool Profiler::collect(FrameSlot& slot, bool wait) {
+    uint32_t queryCount = slot.passCount * 2;
+    VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    if (wait) {
+        flags |= VK_QUERY_RESULT_WAIT_BIT;
+    }
+
+    VkResult result = vkGetQueryPoolResults(
+        device, slot.queryPool, 0, queryCount, queryCount * 2 * sizeof(uint64_t),
+        queryResults.data(), 2 * sizeof(uint64_t), flags);
+
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+        return false;
+
+    for (uint32_t i = 0; i < queryCount; i++) {
+        if (queryResults[i * 2 + 1] == 0)
+            return false;
+    }
+
+    slot.pending = false;
+
+    // The history may have wrapped around since this frame was recorded.
+    FrameProfile& profile = history[slot.frameNumber % history.size()];
+    if (profile.frameNumber != slot.frameNumber)
+        return true;
+
+    double nanosecondsToMilliseconds = static_cast<double>(timestampPeriod) / 1000000.0;
+    uint64_t firstTimestamp = queryResults[0] & timestampMask;
+    uint64_t lastTimestamp = firstTimestamp;
+
+    for (uint32_t i = 0; i < slot.passCount; i++) {
+        uint64_t begin = queryResults[i * 4] & timestampMask;
+        uint64_t end = queryResults[i * 4 + 2] & timestampMask;
+
+        profile.passes[i].gpuStart = (begin - firstTimestamp) * nanosecondsToMilliseconds;
+        profile.passes[i].gpuMilliseconds = (end - begin) * nanosecondsToMilliseconds;
+        lastTimestamp = std::max(lastTimestamp, end);
+    }
+
+    profile.gpuMilliseconds = (lastTimestamp - firstTimestamp) * nanosecondsToMilliseconds;
+    profile.gpuValid = true;
+
+    if (!hasLatest || slot.frameNumber >= latestFrame) {
+        latestFrame = slot.frameNumber;
+        hasLatest = true;
+    }
+
+    return true;
+}
+
+const FrameProfile& Profiler::getLatest() {
+    if (!hasLatest)
+        return emptyProfile;
+
+    return history[latestFrame % history.size()];
+}
+
+const FrameProfile* Profiler::getFrame(uint64_t frameNumber) {
+    if (history.empty() || frameNumber >= frameCount)
+        return nullptr;
+
+    const FrameProfile& profile = history[frameNumber % history.size()];
+    if (profile.frameNumber != frameNumber)
+        return nullptr;
+
+    return &profile;
+}
+
+uint64_t Profiler::getFrameCount() { return frameCount; }
+
+void Profiler::writeTrace(const std::string& path) {
+    std::ofstream file(path);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open trace file!");
+    }
+
+    static const char* phaseNames[cpuPhaseCount] = {"Frame wait", "Acquire", "Record", "Submit",
+                                                    "Present"};
+
+    // Trace event timestamps are in microseconds.
+    auto writeEvent = [&](bool& first, const char* name, const char* category, uint32_t thread,
+                          double startMilliseconds, double milliseconds) {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        file << "{\"name\":\"";
+        writeJsonString(file, name);
+        file << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread
+             << ",\"ts\":" << startMilliseconds * 1000.0 << ",\"dur\":" << milliseconds * 1000.0
+             << "}";
+    };
+
+    file << "{\"traceEvents\":[";
+    file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+            "\"args\":{\"name\":\"CPU\"}},";
+    file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,"
+            "\"args\":{\"name\":\"GPU\"}}";
+    bool first = false;
+
+    uint64_t firstFrame = frameCount > history.size() ? frameCount - history.size() : 0;
+    for (uint64_t frameNumber = firstFrame; frameNumber < frameCount; frameNumber++) {
+        const FrameProfile* profile = getFrame(frameNumber);
+        if (profile == nullptr)
+            continue;
+
+        writeEvent(first, "Frame", "cpu", 0, profile->cpuStart, profile->cpuMilliseconds);
+
+        for (size_t i = 0; i < cpuPhaseCount; i++) {
+            if (profile->cpuPhaseMilliseconds[i] > 0.0) {
+                writeEvent(first, phaseNames[i], "cpu", 0, profile->cpuPhaseStarts[i],
+                           profile->cpuPhaseMilliseconds[i]);
+            }
+        }
+
+        if (!profile->gpuValid)
+            continue;
+
+        // GPU and CPU clocks aren't calibrated against each other, so GPU work is placed at the
+        // point the frame was submitted.
+        double gpuStart = profile->cpuPhaseStarts[static_cast<size_t>(CpuPhase::Submit)];
+        for (uint32_t i = 0; i < profile->passCount; i++) {
+            writeEvent(first, profile->passes[i].name, "gpu", 1,
+                       gpuStart + profile->passes[i].gpuStart,
+                       profile->passes[i].gpuMilliseconds);
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+double Profiler::now() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - epoch)
+        .count();
+}
\ No newline at end of file
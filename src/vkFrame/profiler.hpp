@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "queueFamilyIndices.hpp"
+
+enum class CpuPhase { FrameWait, Acquire, Record, Submit, Present };
+
+const size_t cpuPhaseCount = 5;
+
+struct PassTiming {
+    char name[32];
+    double gpuStart = 0.0;
+    double gpuMilliseconds = 0.0;
+};
+
+struct FrameProfile {
+    uint64_t frameNumber = 0;
+    // CPU times are in milliseconds since the profiler was created.
+    std::array<double, cpuPhaseCount> cpuPhaseStarts{};
+    std::array<double, cpuPhaseCount> cpuPhaseMilliseconds{};
+    double cpuStart = 0.0;
+    double cpuMilliseconds = 0.0;
+    // GPU pass starts are relative to the first timestamp written in the frame.
+    std::vector<PassTiming> passes;
+    uint32_t passCount = 0;
+    double gpuMilliseconds = 0.0;
+    bool gpuValid = false;
+};
+
+class Profiler {
+public:
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    void create(VkPhysicalDevice physicalDevice, VkDevice device,
+                const QueueFamilyIndices& queueFamilyIndices, uint32_t maxFramesInFlight,
+                uint32_t maxPassesPerFrame = 32, uint32_t historySize = 256);
+    void destroy(VkDevice device);
+
+    void beginFrame(uint32_t currentFrame);
+    void endFrame();
+    void beginPhase(CpuPhase phase);
+    void endPhase(CpuPhase phase);
+
+    void beginPass(VkCommandBuffer commandBuffer, const std::string& name);
+    void endPass(VkCommandBuffer commandBuffer);
+
+    // Reads back every frame still waiting on GPU results, call once the device is idle.
+    void collectPending();
+
+    // The most recent frame whose GPU timings have been read back, the GPU results of a frame
+    // are collected without waiting, usually one frame after it was submitted.
+    const FrameProfile& getLatest();
+    const FrameProfile* getFrame(uint64_t frameNumber);
+    uint64_t getFrameCount();
+
+    // Writes every frame still in the history as Chrome/Perfetto trace event JSON.
+    void writeTrace(const std::string& path);
+
+private:
+    struct FrameSlot {
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        uint64_t frameNumber = 0;
+        uint32_t passCount = 0;
+        bool poolReset = false;
+        bool pending = false;
+    };
+
+    bool collect(FrameSlot& slot, bool wait);
+    double now();
+
+    bool enabled = false;
+    bool created = false;
+    VkDevice device = VK_NULL_HANDLE;
+    bool gpuTimingSupported = false;
+    float timestampPeriod = 1.0f;
+    uint64_t timestampMask = ~0ull;
+
+    uint32_t maxPassesPerFrame = 0;
+    std::vector<FrameSlot> slots;
+    std::vector<uint64_t> queryResults;
+    FrameSlot* currentSlot = nullptr;
+    uint32_t openPass = 0;
+    // False when the last beginPass was dropped, so its endPass doesn't write a timestamp.
+    bool passOpen = false;
+
+    std::vector<FrameProfile> history;
+    uint64_t frameCount = 0;
+    uint64_t latestFrame = 0;
+    bool hasLatest = false;
+    FrameProfile emptyProfile;
+
+    std::chrono::steady_clock::time_point epoch;
+};
\ No newline at end of file
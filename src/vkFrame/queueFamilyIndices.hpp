@@ -5,9 +5,14 @@
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    // Only set when the device has a family for this work that can't do graphics, so it can run
+    // alongside the graphics queue instead of sharing it.
+    std::optional<uint32_t> transferFamily;
+    std::optional<uint32_t> computeFamily;
 
     bool isComplete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
 
+    // Queries the device, the renderer does this once and keeps the result in VulkanState.
     static QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) {
         QueueFamilyIndices indices;
 
@@ -17,24 +22,36 @@ struct QueueFamilyIndices {
         std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
-        int i = 0;
-        for (const auto& queueFamily : queueFamilies) {
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        for (uint32_t i = 0; i < queueFamilyCount; i++) {
+            VkQueueFlags flags = queueFamilies[i].queueFlags;
+            bool graphics = flags & VK_QUEUE_GRAPHICS_BIT;
+            bool compute = flags & VK_QUEUE_COMPUTE_BIT;
+
+            if (graphics && !indices.graphicsFamily.has_value()) {
                 indices.graphicsFamily = i;
             }
 
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            if (compute && !graphics && !indices.computeFamily.has_value()) {
+                indices.computeFamily = i;
+            }
 
-            if (presentSupport) {
-                indices.presentFamily = i;
+            // Transfer-only families are usually backed by the copy engine.
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !graphics && !compute &&
+                !indices.transferFamily.has_value()) {
+                indices.transferFamily = i;
             }
 
-            if (indices.isComplete()) {
-                break;
+            // Without a surface there is nothing to present to, the graphics family stands in.
+            VkBool32 presentSupport = surface == VK_NULL_HANDLE && graphics;
+            if (surface != VK_NULL_HANDLE) {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
             }
 
-            i++;
+            // Presenting from the graphics family avoids sharing swapchain images between two.
+            if (presentSupport &&
+                (!indices.presentFamily.has_value() || indices.graphicsFamily == i)) {
+                indices.presentFamily = i;
+            }
         }
 
         return indices;
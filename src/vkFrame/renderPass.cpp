@@ -4,7 +4,7 @@
 void RenderPass::createCustom(
     VkDevice device, Swapchain& swapchain, std::function<VkRenderPass()> setupRenderPass,
     std::function<void(const VkExtent2D& extent)> recreateCallback,
-    std::function<void()> cleanupCallback,
+    std::function<void(DeletionQueue& deletionQueue)> cleanupCallback,
     std::function<void(std::vector<VkImageView>& attachments, VkImageView imageView)>
         setupFramebuffer) {
 
@@ -25,7 +25,8 @@ void RenderPass::createCustom(
 }
 
 void RenderPass::create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator,
-                        Swapchain& swapchain, bool enableDepth, bool enableMsaa) {
+                        Swapchain& swapchain, bool enableDepth, bool enableMsaa,
+                        MemoryBudget* memoryBudget) {
     std::function<VkRenderPass()> setupRenderPass = [&] {
         depthEnabled = enableDepth;
         msaaSamples = enableMsaa ? getMaxUsableSamples(physicalDevice) : VK_SAMPLE_COUNT_1_BIT;
@@ -40,7 +41,7 @@ void RenderPass::create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         colorAttachment.finalLayout = msaaEnabled ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-                                                  : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+                                                  : swapchain.getPresentLayout();
 
         VkAttachmentDescription depthAttachment{};
         depthAttachment.format = findDepthFormat(physicalDevice);
@@ -60,7 +61,7 @@ void RenderPass::create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
         colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorAttachmentResolve.finalLayout = swapchain.getPresentLayout();
 
         VkAttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
@@ -123,15 +124,15 @@ void RenderPass::create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
     };
 
     std::function<void(const VkExtent2D&)> recreateCallback = [=](const VkExtent2D& extent) {
-        createColorResources(allocator, physicalDevice, device, extent);
-        createDepthResources(allocator, physicalDevice, device, extent);
+        createColorResources(allocator, physicalDevice, device, extent, memoryBudget);
+        createDepthResources(allocator, physicalDevice, device, extent, memoryBudget);
     };
 
-    std::function<void()> cleanupCallback = [=] {
-        vkDestroyImageView(device, depthImageView, nullptr);
-        depthImage.destroy(allocator);
-        vkDestroyImageView(device, colorImageView, nullptr);
-        colorImage.destroy(allocator);
+    std::function<void(DeletionQueue&)> cleanupCallback = [=](DeletionQueue& deletionQueue) {
+        deletionQueue.retireImageView(device, depthImageView);
+        depthImage.retire(allocator, deletionQueue);
+        deletionQueue.retireImageView(device, colorImageView);
+        colorImage.retire(allocator, deletionQueue);
     };
 
     std::function<void(std::vector<VkImageView>&, VkImageView)> setupFramebuffer =
@@ -154,23 +155,29 @@ void RenderPass::create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAll
 }
 
 void RenderPass::createImages(VkDevice device, Swapchain& swapchain) {
-    VkSwapchainKHR vkSwapchain = swapchain.getSwapchain();
-    VkFormat format = swapchain.getImageFormat();
-    uint32_t imageCount;
-    vkGetSwapchainImagesKHR(device, vkSwapchain, &imageCount, nullptr);
-    std::vector<VkImage> imagesVk;
-    imagesVk.resize(imageCount);
-    images.clear();
-    images.reserve(imageCount);
-    vkGetSwapchainImagesKHR(device, vkSwapchain, &imageCount, imagesVk.data());
-
-    for (VkImage vkImage : imagesVk) {
-        images.push_back(Image(vkImage, format));
-    }
+    swapchain.getImages(device, images);
+}
+
+void RenderPass::begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
+                       const std::vector<VkClearValue>& clearValues, VkSubpassContents contents) {
+    begin(imageIndex, commandBuffer, extent, clearValues.data(),
+          static_cast<uint32_t>(clearValues.size()), contents);
+}
+
+void RenderPass::begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
+                       std::initializer_list<VkClearValue> clearValues,
+                       VkSubpassContents contents) {
+    begin(imageIndex, commandBuffer, extent, clearValues.begin(),
+          static_cast<uint32_t>(clearValues.size()), contents);
 }
 
 void RenderPass::begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
-                       const std::vector<VkClearValue>& clearValues) {
+                       const VkClearValue* clearValues, uint32_t clearValueCount,
+                       VkSubpassContents contents) {
+    if (profiler != nullptr) {
+        profiler->beginPass(commandBuffer, name);
+    }
+
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = renderPass;
@@ -178,11 +185,18 @@ void RenderPass::begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer,
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = extent;
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+    renderPassInfo.clearValueCount = clearValueCount;
+    renderPassInfo.pClearValues = clearValues;
+
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // Secondary command buffers don't inherit dynamic state, they set their own viewport.
+    if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+        setViewport(commandBuffer, extent);
+    }
+}
 
+void RenderPass::setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent) {
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -198,7 +212,17 @@ void RenderPass::begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer,
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 
-void RenderPass::end(VkCommandBuffer commandBuffer) { vkCmdEndRenderPass(commandBuffer); }
+void RenderPass::end(VkCommandBuffer commandBuffer) {
+    vkCmdEndRenderPass(commandBuffer);
+
+    if (profiler != nullptr) {
+        profiler->endPass(commandBuffer);
+    }
+}
+
+void RenderPass::setName(const std::string& name) { this->name = name; }
+
+void RenderPass::setProfiler(Profiler* profiler) { this->profiler = profiler; }
 
 const VkRenderPass& RenderPass::getRenderPass() { return renderPass; }
 
@@ -238,27 +262,29 @@ void RenderPass::createFramebuffers(VkDevice device, VkExtent2D extent) {
 }
 
 void RenderPass::createDepthResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice,
-                                      VkDevice device, VkExtent2D extent) {
+                                      VkDevice device, VkExtent2D extent,
+                                      MemoryBudget* memoryBudget) {
     VkFormat depthFormat = findDepthFormat(physicalDevice);
 
     depthImage = Image(allocator, extent.width, extent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1, msaaSamples);
+                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1, msaaSamples, memoryBudget);
     depthImageView = depthImage.createView(VK_IMAGE_ASPECT_DEPTH_BIT, device);
 }
 
 void RenderPass::createColorResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice,
-                                      VkDevice device, VkExtent2D extent) {
+                                      VkDevice device, VkExtent2D extent,
+                                      MemoryBudget* memoryBudget) {
     colorImage =
         Image(allocator, extent.width, extent.height, imageFormat, VK_IMAGE_TILING_OPTIMAL,
               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1, msaaSamples);
+              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1, msaaSamples, memoryBudget);
     colorImageView = colorImage.createView(VK_IMAGE_ASPECT_COLOR_BIT, device);
 }
 
 void RenderPass::recreate(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator,
-                          Swapchain& swapchain) {
-    cleanupForRecreation(allocator, device);
+                          Swapchain& swapchain, DeletionQueue& deletionQueue) {
+    cleanupForRecreation(allocator, device, deletionQueue);
 
     const VkExtent2D& extent = swapchain.getExtent();
 
@@ -294,20 +320,31 @@ VkFormat RenderPass::findDepthFormat(VkPhysicalDevice physicalDevice) {
         VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 }
 
-void RenderPass::cleanupForRecreation(VmaAllocator allocator, VkDevice device) {
-    cleanupCallback();
+void RenderPass::cleanupForRecreation(VmaAllocator allocator, VkDevice device,
+                                      DeletionQueue& deletionQueue) {
+    cleanupCallback(deletionQueue);
 
-    for (auto framebuffer : framebuffers) {
-        vkDestroyFramebuffer(device, framebuffer, nullptr);
-    }
+    deletionQueue.push([device, framebuffers = std::move(framebuffers),
+                        imageViews = std::move(imageViews)] {
+        for (auto framebuffer : framebuffers) {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
 
-    for (auto imageView : imageViews) {
-        vkDestroyImageView(device, imageView, nullptr);
-    }
+        for (auto imageView : imageViews) {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+    });
+
+    framebuffers.clear();
+    imageViews.clear();
 }
 
 void RenderPass::cleanup(VmaAllocator allocator, VkDevice device) {
-    cleanupForRecreation(allocator, device);
+    // The device is idle during cleanup, so everything can be destroyed straight away.
+    DeletionQueue deletionQueue;
+    cleanupForRecreation(allocator, device, deletionQueue);
+    deletionQueue.flush();
+
     vkDestroyRenderPass(device, renderPass, nullptr);
 }
 
@@ -315,6 +352,16 @@ const VkFramebuffer& RenderPass::getFramebuffer(const uint32_t imageIndex) {
     return framebuffers[imageIndex];
 }
 
+VkCommandBufferInheritanceInfo RenderPass::getInheritanceInfo(const uint32_t imageIndex) {
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = framebuffers[imageIndex];
+
+    return inheritanceInfo;
+}
+
 const VkSampleCountFlagBits RenderPass::getMaxUsableSamples(VkPhysicalDevice physicalDevice) {
     VkPhysicalDeviceProperties physicalDeviceProperties;
     vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
@@ -5,28 +5,50 @@
 
 #include <array>
 #include <functional>
+#include <initializer_list>
 #include <vector>
 
+#include "deletionQueue.hpp"
 #include "image.hpp"
+#include "profiler.hpp"
 #include "swapchain.hpp"
 
 class RenderPass {
 public:
+    // cleanupCallback releases the attachments made by recreateCallback. Frames in flight may
+    // still be using them, so it should hand them to the deletion queue instead of destroying them.
     void
     createCustom(VkDevice device, Swapchain& swapchain,
                  std::function<VkRenderPass()> setupRenderPass,
                  std::function<void(const VkExtent2D& extent)> recreateCallback,
-                 std::function<void()> cleanupCallback,
+                 std::function<void(DeletionQueue& deletionQueue)> cleanupCallback,
                  std::function<void(std::vector<VkImageView>& attachments, VkImageView imageView)>
                      setupFramebuffer);
+    // The depth and color attachments are reported to memoryBudget when there is one.
     void create(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator,
-                Swapchain& swapchain, bool enableDepth, bool enableMsaa);
+                Swapchain& swapchain, bool enableDepth, bool enableMsaa,
+                MemoryBudget* memoryBudget = nullptr);
     void recreate(VkPhysicalDevice physicalDevice, VkDevice device, VmaAllocator allocator,
-                  Swapchain& swapchain);
+                  Swapchain& swapchain, DeletionQueue& deletionQueue);
 
+    // Pass VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS to record the pass with ParallelCommands.
     void begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
-               const std::vector<VkClearValue>& clearValues);
+               const std::vector<VkClearValue>& clearValues,
+               VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+    // A braced list of clear values lives on the stack, unlike a vector built every frame.
+    void begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
+               std::initializer_list<VkClearValue> clearValues,
+               VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+    void begin(const uint32_t imageIndex, VkCommandBuffer commandBuffer, VkExtent2D extent,
+               const VkClearValue* clearValues, uint32_t clearValueCount,
+               VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
     void end(VkCommandBuffer commandBuffer);
+    void setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent);
+
+    // Identifies this pass in profiler results.
+    void setName(const std::string& name);
+    // The profiler that begin and end report to, the pass isn't timed without one.
+    void setProfiler(Profiler* profiler);
 
     VkFormat findSupportedFormat(VkPhysicalDevice physicalDevice,
                                  const std::vector<VkFormat>& candidates, VkImageTiling tiling,
@@ -35,6 +57,8 @@ public:
 
     const VkRenderPass& getRenderPass();
     const VkFramebuffer& getFramebuffer(const uint32_t imageIndex);
+    // Lets secondary command buffers continue this pass on the given framebuffer.
+    VkCommandBufferInheritanceInfo getInheritanceInfo(const uint32_t imageIndex);
     const VkSampleCountFlagBits getMsaaSamples();
     const bool getMsaaEnabled();
 
@@ -44,20 +68,23 @@ private:
     void createImages(VkDevice device, Swapchain& swapchain);
     void createFramebuffers(VkDevice device, VkExtent2D extent);
     void createDepthResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice,
-                              VkDevice device, VkExtent2D extent);
+                              VkDevice device, VkExtent2D extent, MemoryBudget* memoryBudget);
     void createColorResources(VmaAllocator allocator, VkPhysicalDevice physicalDevice,
-                              VkDevice device, VkExtent2D extent);
+                              VkDevice device, VkExtent2D extent, MemoryBudget* memoryBudget);
     void createImageViews(VkDevice device);
-    void cleanupForRecreation(VmaAllocator allocator, VkDevice device);
+    void cleanupForRecreation(VmaAllocator allocator, VkDevice device,
+                              DeletionQueue& deletionQueue);
 
     const VkSampleCountFlagBits getMaxUsableSamples(VkPhysicalDevice physicalDevice);
 
-    std::function<void()> cleanupCallback;
+    std::function<void(DeletionQueue&)> cleanupCallback;
     std::function<void(const VkExtent2D&)> recreateCallback;
     std::function<void(std::vector<VkImageView>& attachments, VkImageView imageView)>
         setupFramebuffer;
 
     VkRenderPass renderPass;
+    std::string name = "RenderPass";
+    Profiler* profiler = nullptr;
 
     std::vector<Image> images;
     std::vector<VkImageView> imageViews;
@@ -32,22 +32,17 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
     }
 }
 
-void Renderer::run(
-    const std::string& windowTitle, const uint32_t windowWidth, const uint32_t windowHeight,
-    const uint32_t maxFramesInFlight,
-    std::function<void(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height)>
-        initCallback,
-    std::function<void(VulkanState& vulkanState)> updateCallback,
-    std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
-                       uint32_t currentFrame)>
-        renderCallback,
-    std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)> resizeCallback,
-    std::function<void(VulkanState& vulkanState)> cleanupCallback) {
-
-    initWindow(windowTitle, windowWidth, windowHeight);
-    initVulkan(maxFramesInFlight, initCallback);
-    mainLoop(renderCallback, updateCallback, resizeCallback);
-    cleanup(cleanupCallback);
+Profiler& Renderer::getProfiler() { return profiler; }
+
+MemoryBudget& Renderer::getMemoryBudget() { return memoryBudget; }
+
+void Renderer::setPipelineCachePath(const std::string& path) { pipelineCachePath = path; }
+
+void Renderer::setMipCacheDirectory(const std::string& directory) { mipCacheDirectory = directory; }
+
+void Renderer::setGeometryArenaCapacity(VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity) {
+    geometryVertexCapacity = vertexCapacity;
+    geometryIndexCapacity = indexCapacity;
 }
 
 void Renderer::initWindow(const std::string& windowTitle, const uint32_t windowWidth,
@@ -65,11 +60,7 @@ void Renderer::initWindow(const std::string& windowTitle, const uint32_t windowW
                               SDL_WINDOW_VULKAN | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
 }
 
-void Renderer::initVulkan(
-    const uint32_t maxFramesInFlight,
-    std::function<void(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height)>
-        initCallback) {
-
+void Renderer::initVulkan(const uint32_t maxFramesInFlight) {
     createInstance();
     setupDebugMessenger();
     createSurface();
@@ -77,13 +68,40 @@ void Renderer::initVulkan(
     createLogicalDevice();
     createAllocator();
 
-    int32_t width;
-    int32_t height;
-    SDL_Vulkan_GetDrawableSize(window, &width, &height);
+    memoryBudget.create(vulkanState.physicalDevice, vulkanState.allocator, memoryBudgetSupported);
+    vulkanState.memoryBudget = &memoryBudget;
 
-    vulkanState.maxFramesInFlight = maxFramesInFlight;
+    pipelineCache.create(vulkanState.physicalDevice, vulkanState.device, pipelineCachePath);
+    vulkanState.pipelineCache = &pipelineCache;
+    mipCache.create(mipCacheDirectory);
+    vulkanState.mipCache = &mipCache;
+
+    profiler.create(vulkanState.physicalDevice, vulkanState.device,
+                    vulkanState.queueFamilyIndices, maxFramesInFlight);
+    vulkanState.profiler = &profiler;
+
+    // The thread calling run records too, so one less worker thread than there are cores.
+    uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+    workerPool.create(coreCount - 1);
+    vulkanState.workerPool = &workerPool;
 
-    initCallback(vulkanState, window, width, height);
+    vulkanState.maxFramesInFlight = maxFramesInFlight;
+    vulkanState.deletionQueue.create(vulkanState.commands.getTimeline(),
+                                     vulkanState.commands.getFrameTimeline());
+    samplerCache.create(vulkanState.physicalDevice, vulkanState.device, vulkanState.deletionQueue);
+    vulkanState.samplerCache = &samplerCache;
+    vulkanState.commands.getStagingRing().create(
+        vulkanState.allocator, vulkanState.commands.getTimeline(), &memoryBudget);
+    geometryArena.create(vulkanState.allocator, geometryVertexCapacity, geometryIndexCapacity,
+                         &memoryBudget);
+    vulkanState.geometryArena = &geometryArena;
+
+    vulkanState.swapchain.setQueueFamilyIndices(vulkanState.queueFamilyIndices);
+
+    if (headless) {
+        vulkanState.swapchain.setHeadless(vulkanState.allocator, maxFramesInFlight,
+                                          &memoryBudget);
+    }
 
     createSyncObjects();
 }
@@ -100,42 +118,46 @@ void Renderer::createAllocator() {
     aci.device = vulkanState.device;
     aci.instance = instance;
     aci.pVulkanFunctions = &vkFuncs;
+    if (memoryBudgetSupported) {
+        aci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
 
     vmaCreateAllocator(&aci, &vulkanState.allocator);
 }
 
-void Renderer::mainLoop(
-    std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
-                       uint32_t currentFrame)>
-        renderCallback,
-    std::function<void(VulkanState& vulkanState)> updateCallback,
-    std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)> resizeCallback) {
-
-    bool isRunning = true;
+bool Renderer::pollEvents() {
     SDL_Event event;
-    while (isRunning) {
-        while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-            case SDL_WINDOWEVENT:
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-                    framebufferResized = true;
-                }
-
-                break;
-            case SDL_QUIT:
-                isRunning = false;
-                break;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
+        case SDL_WINDOWEVENT:
+            if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+                framebufferResized = true;
             }
+
+            break;
+        case SDL_QUIT:
+            return false;
         }
+    }
+
+    return true;
+}
 
-        updateCallback(vulkanState);
-        drawFrame(renderCallback, resizeCallback);
+void Renderer::getDrawableSize(int32_t& width, int32_t& height) {
+    if (headless) {
+        width = static_cast<int32_t>(headlessWidth);
+        height = static_cast<int32_t>(headlessHeight);
+        return;
     }
 
-    vkDeviceWaitIdle(vulkanState.device);
+    SDL_Vulkan_GetDrawableSize(window, &width, &height);
 }
 
 void Renderer::waitWhileMinimized() {
+    if (headless) {
+        return;
+    }
+
     int32_t width = 0;
     int32_t height = 0;
     SDL_Vulkan_GetDrawableSize(window, &width, &height);
@@ -145,20 +167,29 @@ void Renderer::waitWhileMinimized() {
     }
 }
 
-void Renderer::cleanup(std::function<void(VulkanState& vulkanState)> cleanupCallback) {
-    vulkanState.swapchain.cleanup(vulkanState.allocator, vulkanState.device);
+void Renderer::cleanup() {
+    workerPool.destroy();
 
-    cleanupCallback(vulkanState);
+    vulkanState.deletionQueue.flush();
+    samplerCache.destroy();
+    vulkanState.commands.getStagingRing().destroy(vulkanState.allocator);
+    geometryArena.destroy(vulkanState.allocator);
+    memoryBudget.destroy();
 
     vmaDestroyAllocator(vulkanState.allocator);
 
     for (size_t i = 0; i < vulkanState.maxFramesInFlight; i++) {
         vkDestroySemaphore(vulkanState.device, renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(vulkanState.device, imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(vulkanState.device, inFlightFences[i], nullptr);
     }
 
     vulkanState.commands.destroy(vulkanState.device);
+    vulkanState.commands.destroyTimelines(vulkanState.device);
+
+    profiler.destroy(vulkanState.device);
+
+    pipelineCache.destroy(vulkanState.device);
+    mipCache.destroy();
 
     vkDestroyDevice(vulkanState.device, nullptr);
 
@@ -166,9 +197,15 @@ void Renderer::cleanup(std::function<void(VulkanState& vulkanState)> cleanupCall
         DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
     }
 
-    vkDestroySurfaceKHR(instance, vulkanState.surface, nullptr);
+    if (!headless) {
+        vkDestroySurfaceKHR(instance, vulkanState.surface, nullptr);
+    }
     vkDestroyInstance(instance, nullptr);
 
+    if (headless) {
+        return;
+    }
+
     SDL_DestroyWindow(window);
     SDL_Vulkan_UnloadLibrary();
     SDL_Quit();
@@ -239,6 +276,11 @@ void Renderer::setupDebugMessenger() {
 }
 
 void Renderer::createSurface() {
+    if (headless) {
+        vulkanState.surface = VK_NULL_HANDLE;
+        return;
+    }
+
     if (!SDL_Vulkan_CreateSurface(window, instance, &vulkanState.surface)) {
         throw std::runtime_error("Failed to create window surface!");
     }
@@ -265,16 +307,26 @@ void Renderer::pickPhysicalDevice() {
     if (vulkanState.physicalDevice == VK_NULL_HANDLE) {
         throw std::runtime_error("Failed to find a suitable GPU!");
     }
+
+    vulkanState.queueFamilyIndices =
+        QueueFamilyIndices::findQueueFamilies(vulkanState.physicalDevice, vulkanState.surface);
 }
 
 void Renderer::createLogicalDevice() {
-    QueueFamilyIndices indices =
-        QueueFamilyIndices::findQueueFamilies(vulkanState.physicalDevice, vulkanState.surface);
+    const QueueFamilyIndices& indices = vulkanState.queueFamilyIndices;
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(),
                                               indices.presentFamily.value()};
 
+    if (indices.transferFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
+
+    if (indices.computeFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.computeFamily.value());
+    }
+
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueCreateInfo{};
@@ -285,20 +337,50 @@ void Renderer::createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(vulkanState.physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    // Whichever compressed formats the device has, Image::createCompressedTexture checks the
+    // format itself and decompresses the others.
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+
+    VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+    deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    deviceFeatures12.timelineSemaphore = VK_TRUE;
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &deviceFeatures12;
 
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     createInfo.pEnabledFeatures = &deviceFeatures;
 
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    std::vector<const char*> extensions = getDeviceExtensions();
+
+    // Optional, without it VMA estimates the budget from the heap sizes.
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(vulkanState.physicalDevice, nullptr, &extensionCount,
+                                         nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(vulkanState.physicalDevice, nullptr, &extensionCount,
+                                         availableExtensions.data());
+
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            memoryBudgetSupported = true;
+        }
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     if (enableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
@@ -315,6 +397,13 @@ void Renderer::createLogicalDevice() {
     vkGetDeviceQueue(vulkanState.device, indices.graphicsFamily.value(), 0,
                      &vulkanState.graphicsQueue);
     vkGetDeviceQueue(vulkanState.device, indices.presentFamily.value(), 0, &presentQueue);
+
+    vkGetDeviceQueue(vulkanState.device,
+                     indices.transferFamily.value_or(indices.graphicsFamily.value()), 0,
+                     &vulkanState.transferQueue);
+    vkGetDeviceQueue(vulkanState.device,
+                     indices.computeFamily.value_or(indices.graphicsFamily.value()), 0,
+                     &vulkanState.computeQueue);
 }
 
 bool Renderer::hasStencilComponent(VkFormat format) {
@@ -338,85 +427,118 @@ uint32_t Renderer::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags pro
 void Renderer::createSyncObjects() {
     imageAvailableSemaphores.resize(vulkanState.maxFramesInFlight);
     renderFinishedSemaphores.resize(vulkanState.maxFramesInFlight);
-    inFlightFences.resize(vulkanState.maxFramesInFlight);
+    // Zero is the timeline's initial value, so frames that haven't been submitted never wait.
+    frameTimelineValues.assign(vulkanState.maxFramesInFlight, 0);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
     for (size_t i = 0; i < vulkanState.maxFramesInFlight; i++) {
         if (vkCreateSemaphore(vulkanState.device, &semaphoreInfo, nullptr,
                               &imageAvailableSemaphores[i]) != VK_SUCCESS ||
             vkCreateSemaphore(vulkanState.device, &semaphoreInfo, nullptr,
-                              &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(vulkanState.device, &fenceInfo, nullptr, &inFlightFences[i]) !=
-                VK_SUCCESS) {
+                              &renderFinishedSemaphores[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create synchronization objects for a frame!");
         }
     }
+
+    vulkanState.commands.createTimelines(vulkanState.device);
 }
 
-void Renderer::drawFrame(
-    std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
-                       uint32_t currentFrame)>
-        renderCallback,
-    std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)> resizeCallback) {
+bool Renderer::acquireFrame(uint32_t& imageIndex) {
+    profiler.beginFrame(currentFrame);
+
+    // Only blocks if the GPU is still using the resources of the last frame in this slot.
+    profiler.beginPhase(CpuPhase::FrameWait);
+    vulkanState.commands.getTimeline().wait(frameTimelineValues[currentFrame]);
+    profiler.endPhase(CpuPhase::FrameWait);
 
-    vkWaitForFences(vulkanState.device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    // Whatever is retired while the frame is recorded waits for this value, a frame that fails
+    // to acquire keeps its reservation for the next attempt.
+    vulkanState.commands.getFrameTimeline().reserveValue();
 
-    uint32_t imageIndex;
+    vulkanState.deletionQueue.collect();
+    memoryBudget.beginFrame();
+
+    profiler.beginPhase(CpuPhase::Acquire);
     VkResult result = vulkanState.swapchain.getNextImage(
         vulkanState.device, imageAvailableSemaphores[currentFrame], imageIndex);
+    profiler.endPhase(CpuPhase::Acquire);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        waitWhileMinimized();
-        int32_t width;
-        int32_t height;
-        SDL_Vulkan_GetDrawableSize(window, &width, &height);
-        vulkanState.swapchain.recreate(vulkanState.allocator, vulkanState.device,
-                                       vulkanState.physicalDevice, vulkanState.surface, width,
-                                       height);
-        resizeCallback(vulkanState, width, height);
-        return;
+        profiler.endFrame();
+        return false;
     } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
         throw std::runtime_error("Failed to acquire swap chain image!");
     }
 
-    vkResetFences(vulkanState.device, 1, &inFlightFences[currentFrame]);
+    return true;
+}
 
+VkCommandBuffer Renderer::beginFrameRecording(const uint32_t imageIndex) {
+    profiler.beginPhase(CpuPhase::Record);
     vulkanState.commands.resetBuffer(imageIndex, currentFrame);
+    return vulkanState.commands.getBuffer(currentFrame);
+}
+
+bool Renderer::submitFrame(const uint32_t imageIndex) {
+    profiler.endPhase(CpuPhase::Record);
+
     const VkCommandBuffer& currentBuffer = vulkanState.commands.getBuffer(currentFrame);
-    renderCallback(vulkanState, currentBuffer, imageIndex, currentFrame);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+    Timeline& timeline = vulkanState.commands.getTimeline();
+    Timeline& frameTimeline = vulkanState.commands.getFrameTimeline();
+    uint64_t frameValue = timeline.nextValue();
+    frameTimelineValues[currentFrame] = frameValue;
+
+    // Offscreen images are never acquired or presented, so only the timelines are signalled.
     VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
+    uint64_t waitValues[] = {0};
     VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.waitSemaphoreCount = headless ? 0 : 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
 
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &currentBuffer;
 
-    VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
-    submitInfo.signalSemaphoreCount = 1;
+    VkSemaphore renderFinishedSemaphore = renderFinishedSemaphores[currentFrame];
+    VkSemaphore signalSemaphores[] = {timeline.getSemaphore(), frameTimeline.getSemaphore(),
+                                      renderFinishedSemaphore};
+    uint64_t signalValues[] = {frameValue, frameTimeline.nextValue(), 0};
+    submitInfo.signalSemaphoreCount = headless ? 2 : 3;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(vulkanState.graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) !=
-        VK_SUCCESS) {
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
+    profiler.beginPhase(CpuPhase::Submit);
+    if (vkQueueSubmit(vulkanState.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer!");
     }
+    vulkanState.commands.getStagingRing().submit(frameStagingOwner, frameValue);
+    profiler.endPhase(CpuPhase::Submit);
+
+    currentFrame = (currentFrame + 1) % vulkanState.maxFramesInFlight;
+
+    if (headless) {
+        profiler.endFrame();
+        return true;
+    }
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
 
     VkSwapchainKHR swapChains[] = {vulkanState.swapchain.getSwapchain()};
     presentInfo.swapchainCount = 1;
@@ -424,23 +546,30 @@ void Renderer::drawFrame(
 
     presentInfo.pImageIndices = &imageIndex;
 
-    result = vkQueuePresentKHR(presentQueue, &presentInfo);
+    profiler.beginPhase(CpuPhase::Present);
+    VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+        vulkanState.swapchain.presented(vulkanState.device, vulkanState.deletionQueue);
+    }
+    profiler.endPhase(CpuPhase::Present);
+    profiler.endFrame();
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized) {
         framebufferResized = false;
-        waitWhileMinimized();
-        int32_t width;
-        int32_t height;
-        SDL_Vulkan_GetDrawableSize(window, &width, &height);
-        vulkanState.swapchain.recreate(vulkanState.allocator, vulkanState.device,
-                                       vulkanState.physicalDevice, vulkanState.surface, width,
-                                       height);
-        resizeCallback(vulkanState, width, height);
+        return false;
     } else if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to present swap chain image!");
     }
 
-    currentFrame = (currentFrame + 1) % vulkanState.maxFramesInFlight;
+    return true;
+}
+
+void Renderer::recreateSwapchain(int32_t& width, int32_t& height) {
+    waitWhileMinimized();
+    getDrawableSize(width, height);
+    vulkanState.swapchain.recreate(vulkanState.allocator, vulkanState.device,
+                                   vulkanState.physicalDevice, vulkanState.surface, width, height,
+                                   vulkanState.deletionQueue);
 }
 
 bool Renderer::isDeviceSuitable(VkPhysicalDevice device) {
@@ -448,19 +577,24 @@ bool Renderer::isDeviceSuitable(VkPhysicalDevice device) {
 
     bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-    bool swapChainAdequate = false;
-    if (extensionsSupported) {
+    bool swapChainAdequate = headless;
+    if (extensionsSupported && !headless) {
         SwapchainSupportDetails swapchainSupport =
             vulkanState.swapchain.querySupport(device, vulkanState.surface);
         swapChainAdequate =
             !swapchainSupport.formats.empty() && !swapchainSupport.presentModes.empty();
     }
 
-    VkPhysicalDeviceFeatures supportedFeatures;
-    vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+    VkPhysicalDeviceVulkan12Features supportedFeatures12{};
+    supportedFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &supportedFeatures12;
+    vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
 
     return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-           supportedFeatures.samplerAnisotropy;
+           supportedFeatures.features.samplerAnisotropy && supportedFeatures12.timelineSemaphore;
 }
 
 bool Renderer::checkDeviceExtensionSupport(VkPhysicalDevice device) {
@@ -471,6 +605,7 @@ bool Renderer::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
                                          availableExtensions.data());
 
+    std::vector<const char*> deviceExtensions = getDeviceExtensions();
     std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 
     for (const auto& extension : availableExtensions) {
@@ -480,9 +615,26 @@ bool Renderer::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     return requiredExtensions.empty();
 }
 
+std::vector<const char*> Renderer::getDeviceExtensions() {
+    if (headless) {
+        return {};
+    }
+
+    return deviceExtensions;
+}
+
 std::vector<const char*> Renderer::getRequiredExtensions() {
     uint32_t extensionCount = 0;
     std::vector<const char*> extensions;
+
+    if (headless) {
+        if (enableValidationLayers) {
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        return extensions;
+    }
+
     if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, nullptr)) {
         throw std::runtime_error("Unable to get Vulkan extensions!");
     }
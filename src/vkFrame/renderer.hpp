@@ -28,12 +28,26 @@
 #include <vector>
 
 #include "buffer.hpp"
+#include "bufferUpdates.hpp"
 #include "commands.hpp"
+#include "deletionQueue.hpp"
+#include "dynamicUniformBuffer.hpp"
+#include "geometryArena.hpp"
+#include "memoryBudget.hpp"
+#include "mipChain.hpp"
 #include "model.hpp"
+#include "parallelCommands.hpp"
 #include "pipeline.hpp"
+#include "pipelineCache.hpp"
+#include "profiler.hpp"
 #include "queueFamilyIndices.hpp"
+#include "samplerCache.hpp"
+#include "streamingTexture.hpp"
 #include "swapchain.hpp"
+#include "textureLoader.hpp"
 #include "uniformBuffer.hpp"
+#include "uploadBatch.hpp"
+#include "workerPool.hpp"
 
 VkResult CreateDebugUtilsMessengerEXT(VkInstance instance,
                                       const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
@@ -46,40 +60,118 @@ struct VulkanState {
     VkPhysicalDevice physicalDevice;
     VkDevice device;
     VkSurfaceKHR surface;
+    QueueFamilyIndices queueFamilyIndices;
     VkQueue graphicsQueue;
+    // These are the graphics queue when the device has no dedicated transfer or compute family,
+    // check queueFamilyIndices to tell them apart.
+    VkQueue transferQueue;
+    VkQueue computeQueue;
     VmaAllocator allocator;
     Swapchain swapchain;
     Commands commands;
+    // Destroys resources once the frames that may use them have completed.
+    DeletionQueue deletionQueue;
     uint32_t maxFramesInFlight;
+    Profiler* profiler;
+    WorkerPool* workerPool;
+    MemoryBudget* memoryBudget;
+    // Shares one sampler between every texture sampled the same way.
+    SamplerCache* samplerCache;
+    // Every Model's mesh is sub-allocated from here.
+    GeometryArena* geometryArena;
+    PipelineCache* pipelineCache;
+    MipCache* mipCache;
 };
 
 class Renderer {
 public:
-    void
-    run(const std::string& windowTitle, const uint32_t windowWidth, const uint32_t windowHeight,
-        const uint32_t maxFramesInFlight,
-        std::function<void(VulkanState& vulkanState, SDL_Window* window, int32_t width,
-                           int32_t height)>
-            initCallback,
-        std::function<void(VulkanState& vulkanState)> updateCallback,
-        std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer,
-                           uint32_t imageIndex, uint32_t currentFrame)>
-            renderCallback,
-        std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)> resizeCallback,
-        std::function<void(VulkanState& vulkanState)> cleanupCallback);
+    // App must provide the following methods, which are called directly every frame:
+    // void init(VulkanState& vulkanState, SDL_Window* window, int32_t width, int32_t height);
+    // void update(VulkanState& vulkanState);
+    // void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
+    //             uint32_t currentFrame);
+    // void resize(VulkanState& vulkanState, int32_t width, int32_t height);
+    // void cleanup(VulkanState& vulkanState);
+    template <typename App>
+    void run(App& app, const std::string& windowTitle, const uint32_t windowWidth,
+             const uint32_t windowHeight, const uint32_t maxFramesInFlight) {
+        initWindow(windowTitle, windowWidth, windowHeight);
+        initVulkan(maxFramesInFlight);
+        initApp(app);
+
+        while (pollEvents()) {
+            app.update(vulkanState);
+            drawFrame(app);
+        }
+
+        vkDeviceWaitIdle(vulkanState.device);
+        cleanupApp(app);
+    }
+
+    // Renders frameCount frames as fast as possible into offscreen images, without creating
+    // a window, surface or swapchain. The window passed to App::init is null.
+    template <typename App>
+    void runHeadless(App& app, const uint32_t width, const uint32_t height,
+                     const uint32_t maxFramesInFlight, const uint32_t frameCount) {
+        headless = true;
+        headlessWidth = width;
+        headlessHeight = height;
+
+        initVulkan(maxFramesInFlight);
+        initApp(app);
+
+        for (uint32_t i = 0; i < frameCount; i++) {
+            app.update(vulkanState);
+            drawFrame(app);
+        }
+
+        vkDeviceWaitIdle(vulkanState.device);
+        cleanupApp(app);
+    }
+
+    // Enable the profiler before calling run for it to collect timings.
+    Profiler& getProfiler();
+    // Heap usage against the driver's budget and the bytes held by each kind of resource, call
+    // setStatsDump before run to have the statistics written out periodically.
+    MemoryBudget& getMemoryBudget();
+
+    // Where compiled pipelines are saved between runs, set before calling run.
+    void setPipelineCachePath(const std::string& path);
+    // The directory generated mip chains are saved in between runs, set before calling run.
+    void setMipCacheDirectory(const std::string& directory);
+    // How many bytes of vertices and indices every Model shares, set before calling run.
+    void setGeometryArenaCapacity(VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity);
 
 private:
-    SDL_Window* window;
+    SDL_Window* window = nullptr;
+
+    bool headless = false;
+    uint32_t headlessWidth = 0;
+    uint32_t headlessHeight = 0;
 
     VkInstance instance;
     VkDebugUtilsMessengerEXT debugMessenger;
     VkQueue presentQueue;
 
     VulkanState vulkanState;
+    Profiler profiler;
+    WorkerPool workerPool;
+    PipelineCache pipelineCache;
+    MemoryBudget memoryBudget;
+    SamplerCache samplerCache;
+    // Whether VK_EXT_memory_budget was enabled, so VMA can ask the driver for real budgets.
+    bool memoryBudgetSupported = false;
+    std::string pipelineCachePath = "pipelineCache.bin";
+    MipCache mipCache;
+    std::string mipCacheDirectory = "mipCache";
+    GeometryArena geometryArena;
+    VkDeviceSize geometryVertexCapacity = 32 * 1024 * 1024;
+    VkDeviceSize geometryIndexCapacity = 16 * 1024 * 1024;
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
-    std::vector<VkFence> inFlightFences;
+    // The timeline value each frame in flight signals when its GPU work completes.
+    std::vector<uint64_t> frameTimelineValues;
     uint32_t currentFrame = 0;
 
     bool framebufferResized = false;
@@ -89,28 +181,62 @@ private:
 
     static void framebufferResizeCallback(SDL_Window* window, int width, int height);
 
-    void initVulkan(const uint32_t maxFramesInFlight,
-                    std::function<void(VulkanState& vulkanState, SDL_Window* window, int32_t width,
-                                       int32_t height)>
-                        initCallback);
+    template <typename App> void initApp(App& app) {
+        int32_t width;
+        int32_t height;
+        getDrawableSize(width, height);
+
+        app.init(vulkanState, window, width, height);
+    }
+
+    template <typename App> void drawFrame(App& app) {
+        uint32_t imageIndex;
+        if (!acquireFrame(imageIndex)) {
+            resizeApp(app);
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = beginFrameRecording(imageIndex);
+        app.render(vulkanState, commandBuffer, imageIndex, currentFrame);
+
+        if (!submitFrame(imageIndex)) {
+            resizeApp(app);
+        }
+    }
+
+    template <typename App> void resizeApp(App& app) {
+        int32_t width;
+        int32_t height;
+        recreateSwapchain(width, height);
+
+        app.resize(vulkanState, width, height);
+    }
+
+    template <typename App> void cleanupApp(App& app) {
+        vulkanState.swapchain.cleanup(vulkanState.allocator, vulkanState.device);
+
+        app.cleanup(vulkanState);
+
+        cleanup();
+    }
+
+    void initVulkan(const uint32_t maxFramesInFlight);
     void createInstance();
     void createAllocator();
     void createLogicalDevice();
 
-    void mainLoop(std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer,
-                                     uint32_t imageIndex, uint32_t currentFrame)>
-                      renderCallback,
-                  std::function<void(VulkanState& vulkanState)> updateCallback,
-                  std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)>
-                      resizeCallback);
-    void drawFrame(std::function<void(VulkanState& vulkanState, VkCommandBuffer commandBuffer,
-                                      uint32_t imageIndex, uint32_t currentFrame)>
-                       renderCallback,
-                   std::function<void(VulkanState& vulkanState, int32_t width, int32_t height)>
-                       resizeCallback);
+    // Returns false once the window has been closed.
+    bool pollEvents();
+    // Returns false if the swapchain is out of date and no image was acquired.
+    bool acquireFrame(uint32_t& imageIndex);
+    VkCommandBuffer beginFrameRecording(const uint32_t imageIndex);
+    // Returns false if the swapchain needs to be recreated after presenting.
+    bool submitFrame(const uint32_t imageIndex);
+    void recreateSwapchain(int32_t& width, int32_t& height);
     void waitWhileMinimized();
+    void getDrawableSize(int32_t& width, int32_t& height);
 
-    void cleanup(std::function<void(VulkanState& vulkanState)> cleanupCallback);
+    void cleanup();
 
     void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
     void setupDebugMessenger();
@@ -129,7 +255,7 @@ private:
 
     bool isDeviceSuitable(VkPhysicalDevice device);
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
-    QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
+    std::vector<const char*> getDeviceExtensions();
     std::vector<const char*> getRequiredExtensions();
     bool checkValidationLayerSupport();
 
@@ -0,0 +1,126 @@
+#include "samplerCache.hpp"
+
+namespace {
+
+// Every field but sType and pNext, with floats compared by their bits.
+const size_t samplerFieldCount = 16;
+
+void getFields(const VkSamplerCreateInfo& samplerInfo, uint32_t (&fields)[samplerFieldCount]) {
+    auto floatBits = [](float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+
+    fields[0] = samplerInfo.flags;
+    fields[1] = samplerInfo.magFilter;
+    fields[2] = samplerInfo.minFilter;
+    fields[3] = samplerInfo.mipmapMode;
+    fields[4] = samplerInfo.addressModeU;
+    fields[5] = samplerInfo.addressModeV;
+    fields[6] = samplerInfo.addressModeW;
+    fields[7] = floatBits(samplerInfo.mipLodBias);
+    fields[8] = samplerInfo.anisotropyEnable;
+    fields[9] = floatBits(samplerInfo.maxAnisotropy);
+    fields[10] = samplerInfo.compareEnable;
+    fields[11] = samplerInfo.compareOp;
+    fields[12] = floatBits(samplerInfo.minLod);
+    fields[13] = floatBits(samplerInfo.maxLod);
+    fields[14] = samplerInfo.borderColor;
+    fields[15] = samplerInfo.unnormalizedCoordinates;
+}
+
+} // namespace
+
+size_t SamplerCache::Hash::operator()(const VkSamplerCreateInfo& samplerInfo) const {
+    uint32_t fields[samplerFieldCount];
+    getFields(samplerInfo, fields);
+
+    // FNV-1a over the fields.
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t field : fields) {
+        hash = (hash ^ field) * 0x100000001B3ull;
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+bool SamplerCache::Equal::operator()(const VkSamplerCreateInfo& a,
+                                     const VkSamplerCreateInfo& b) const {
+    uint32_t fieldsA[samplerFieldCount];
+    uint32_t fieldsB[samplerFieldCount];
+    getFields(a, fieldsA);
+    getFields(b, fieldsB);
+
+    return memcmp(fieldsA, fieldsB, sizeof(fieldsA)) == 0;
+}
+
+void SamplerCache::create(VkPhysicalDevice physicalDevice, VkDevice device,
+                          DeletionQueue& deletionQueue) {
+    this->device = device;
+    this->deletionQueue = &deletionQueue;
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    limits = properties.limits;
+}
+
+void SamplerCache::destroy() {
+    size_t leakedCount = 0;
+    for (auto& [samplerInfo, entry] : samplers) {
+        leakedCount += entry.refCount;
+        vkDestroySampler(device, entry.sampler, nullptr);
+    }
+
+    if (leakedCount != 0) {
+        std::cerr << "Leaked " << leakedCount << " sampler references!" << std::endl;
+    }
+
+    samplers.clear();
+    samplerInfos.clear();
+}
+
+VkSampler SamplerCache::acquire(const VkSamplerCreateInfo& samplerInfo) {
+    if (samplerInfo.pNext != nullptr) {
+        throw std::runtime_error("Failed to cache sampler with chained structures!");
+    }
+
+    VkSamplerCreateInfo key = samplerInfo;
+    key.maxAnisotropy = std::min(key.maxAnisotropy, limits.maxSamplerAnisotropy);
+
+    Entry& entry = samplers[key];
+    if (entry.sampler == VK_NULL_HANDLE) {
+        if (vkCreateSampler(device, &key, nullptr, &entry.sampler) != VK_SUCCESS) {
+            samplers.erase(key);
+            throw std::runtime_error("Failed to create texture sampler!");
+        }
+
+        samplerInfos[entry.sampler] = key;
+    }
+
+    entry.refCount++;
+
+    return entry.sampler;
+}
+
+void SamplerCache::release(VkSampler sampler) {
+    auto samplerInfo = samplerInfos.find(sampler);
+    if (samplerInfo == samplerInfos.end()) {
+        throw std::runtime_error("Released a sampler the cache didn't create!");
+    }
+
+    auto entry = samplers.find(samplerInfo->second);
+    entry->second.refCount--;
+
+    if (entry->second.refCount == 0) {
+        deletionQueue->retireSampler(device, sampler);
+        samplers.erase(entry);
+        samplerInfos.erase(samplerInfo);
+    }
+}
+
+float SamplerCache::getMaxAnisotropy() const { return limits.maxSamplerAnisotropy; }
+
+const VkPhysicalDeviceLimits& SamplerCache::getLimits() const { return limits; }
+
+size_t SamplerCache::getSamplerCount() const { return samplers.size(); }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "deletionQueue.hpp"
+
+/*
+ * Hands out one VkSampler per distinct sampler state, shared by every texture that asks for the
+ * same state and counted so it is destroyed when the last one releases it. Creating samplers is
+ * slow and devices only allow maxSamplerAllocationCount of them, while most textures share a
+ * handful of states. Not thread safe.
+ */
+class SamplerCache {
+public:
+    // The device's limits are queried here once.
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, DeletionQueue& deletionQueue);
+    // Destroys every sampler, reporting the ones that were never released.
+    void destroy();
+
+    // Returns the sampler for samplerInfo, creating it the first time the state is asked for.
+    // maxAnisotropy is clamped to the device's limit, chained structures aren't supported.
+    VkSampler acquire(const VkSamplerCreateInfo& samplerInfo);
+    // Once every acquire of the sampler has been released it is destroyed, after the frames
+    // that may still use it have completed.
+    void release(VkSampler sampler);
+
+    float getMaxAnisotropy() const;
+    const VkPhysicalDeviceLimits& getLimits() const;
+    size_t getSamplerCount() const;
+
+private:
+    struct Hash {
+        size_t operator()(const VkSamplerCreateInfo& samplerInfo) const;
+    };
+
+    struct Equal {
+        bool operator()(const VkSamplerCreateInfo& a, const VkSamplerCreateInfo& b) const;
+    };
+
+    struct Entry {
+        VkSampler sampler = VK_NULL_HANDLE;
+        uint32_t refCount = 0;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;
+    DeletionQueue* deletionQueue = nullptr;
+    VkPhysicalDeviceLimits limits{};
+
+    std::unordered_map<VkSamplerCreateInfo, Entry, Hash, Equal> samplers;
+    // The state each sampler was created with, to find its entry on release.
+    std::unordered_map<VkSampler, VkSamplerCreateInfo> samplerInfos;
+};
\ No newline at end of file
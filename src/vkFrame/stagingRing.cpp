@@ -0,0 +1,207 @@
+#include "stagingRing.hpp"
+
+void StagingRing::create(VmaAllocator allocator, Timeline& timeline, MemoryBudget* memoryBudget,
+                         VkDeviceSize capacity) {
+    this->timeline = &timeline;
+    this->capacity = capacity;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocCreateInfo = {};
+    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocCreateInfo.flags =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocCreateInfo.pUserData = MemoryBudget::tag(memoryBudget, MemoryCategory::Staging);
+
+    VmaAllocationInfo allocInfo;
+    if (vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &buffer, &allocation,
+                        &allocInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create staging ring!");
+    }
+    MemoryBudget::track(allocator, allocation);
+
+    mappedData = static_cast<char*>(allocInfo.pMappedData);
+    head = 0;
+    usedBytes = 0;
+    regions.assign(64, Region{});
+    openOwners.clear();
+    firstRegion = 0;
+    regionCount = 0;
+}
+
+void StagingRing::destroy(VmaAllocator allocator) {
+    if (buffer == VK_NULL_HANDLE)
+        return;
+
+    MemoryBudget::untrack(allocator, allocation);
+    vmaDestroyBuffer(allocator, buffer, allocation);
+    buffer = VK_NULL_HANDLE;
+    mappedData = nullptr;
+}
+
+StagingOwner StagingRing::beginOwner() {
+    openOwners.push_back(nextOwner);
+
+    return nextOwner++;
+}
+
+StagingAllocation StagingRing::allocate(StagingOwner owner, VkDeviceSize size,
+                                        VkDeviceSize alignment) {
+    if (!isOpen(owner)) {
+        throw std::runtime_error("Staged an upload for an owner that was already submitted!");
+    }
+
+    if (size > capacity) {
+        throw std::runtime_error("Upload is larger than the staging ring!");
+    }
+
+    reclaim();
+
+    // Starting over from the beginning of an empty ring avoids wrapping needlessly.
+    if (usedBytes == 0) {
+        head = 0;
+    }
+
+    VkDeviceSize offset = (head + alignment - 1) / alignment * alignment;
+    // A region never wraps around the end of the ring, the space before the end is skipped.
+    if (offset + size > capacity) {
+        offset = 0;
+    }
+
+    VkDeviceSize consumedBytes = offset >= head ? offset - head + size : capacity - head + size;
+
+    while (capacity - usedBytes < consumedBytes) {
+        if (regionCount == 0 || getRegion(0).state == RegionState::Pending) {
+            throw std::runtime_error("Staging ring is full of uploads that weren't submitted!");
+        }
+
+        timeline->wait(getRegion(0).timelineValue);
+        reclaim();
+    }
+
+    pushRegion(Region{owner, offset, head, consumedBytes, RegionState::Pending, 0});
+    head = offset + size;
+    usedBytes += consumedBytes;
+
+    StagingAllocation stagingAllocation;
+    stagingAllocation.buffer = buffer;
+    stagingAllocation.offset = offset;
+    stagingAllocation.size = size;
+    stagingAllocation.data = mappedData + offset;
+
+    return stagingAllocation;
+}
+
+void StagingRing::flush(VmaAllocator allocator, const StagingAllocation& stagingAllocation) {
+    vmaFlushAllocation(allocator, allocation, stagingAllocation.offset, stagingAllocation.size);
+}
+
+void StagingRing::release(StagingOwner owner, const StagingAllocation& allocation) {
+    bool released = false;
+    for (size_t i = 0; i < regionCount && !released; i++) {
+        Region& region = getRegion(i);
+        if (region.owner == owner && region.offset == allocation.offset &&
+            region.state == RegionState::Pending) {
+            region.state = RegionState::Released;
+            released = true;
+        }
+    }
+
+    if (!released) {
+        throw std::runtime_error("Released staging that its owner doesn't hold!");
+    }
+
+    popReleased();
+}
+
+void StagingRing::releaseOwner(StagingOwner owner) {
+    if (!isOpen(owner)) {
+        throw std::runtime_error("Released staging for an owner that isn't open!");
+    }
+
+    if (owner != frameStagingOwner) {
+        openOwners.erase(std::find(openOwners.begin(), openOwners.end(), owner));
+    }
+
+    for (size_t i = 0; i < regionCount; i++) {
+        Region& region = getRegion(i);
+        if (region.owner == owner && region.state == RegionState::Pending) {
+            region.state = RegionState::Released;
+        }
+    }
+
+    popReleased();
+}
+
+void StagingRing::submit(StagingOwner owner, uint64_t timelineValue) {
+    if (!isOpen(owner)) {
+        throw std::runtime_error("Submitted staging for an owner that isn't open!");
+    }
+
+    if (owner != frameStagingOwner) {
+        openOwners.erase(std::find(openOwners.begin(), openOwners.end(), owner));
+    }
+
+    for (size_t i = 0; i < regionCount; i++) {
+        Region& region = getRegion(i);
+        if (region.owner == owner && region.state == RegionState::Pending) {
+            region.state = RegionState::Submitted;
+            region.timelineValue = timelineValue;
+        }
+    }
+}
+
+VkDeviceSize StagingRing::getCapacity() const { return capacity; }
+
+void StagingRing::reclaim() {
+    // A region whose owner hasn't submitted yet holds on to every region after it, even ones
+    // that have completed, since the free space has to stay contiguous.
+    while (regionCount != 0) {
+        Region& region = getRegion(0);
+        if (region.state == RegionState::Pending ||
+            (region.state == RegionState::Submitted && !timeline->isComplete(region.timelineValue)))
+            break;
+
+        usedBytes -= region.consumedBytes;
+        firstRegion = (firstRegion + 1) % regions.size();
+        regionCount--;
+    }
+}
+
+void StagingRing::popReleased() {
+    // Older released regions wait for reclaim, since the free space has to stay contiguous.
+    while (regionCount != 0 && getRegion(regionCount - 1).state == RegionState::Released) {
+        Region& region = getRegion(regionCount - 1);
+        head = region.previousHead;
+        usedBytes -= region.consumedBytes;
+        regionCount--;
+    }
+}
+
+bool StagingRing::isOpen(StagingOwner owner) const {
+    return owner == frameStagingOwner ||
+           std::find(openOwners.begin(), openOwners.end(), owner) != openOwners.end();
+}
+
+StagingRing::Region& StagingRing::getRegion(size_t index) {
+    return regions[(firstRegion + index) % regions.size()];
+}
+
+void StagingRing::pushRegion(const Region& region) {
+    if (regionCount == regions.size()) {
+        std::vector<Region> grown(regions.size() * 2);
+        for (size_t i = 0; i < regionCount; i++) {
+            grown[i] = getRegion(i);
+        }
+
+        regions.swap(grown);
+        firstRegion = 0;
+    }
+
+    regions[(firstRegion + regionCount) % regions.size()] = region;
+    regionCount++;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "memoryBudget.hpp"
+#include "timeline.hpp"
+
+// Whoever stages regions and later submits the commands that read them. Regions are only recycled
+// by their own owner's submission.
+using StagingOwner = uint64_t;
+
+// Uploads recorded into the frame's command buffer, submitted by the renderer with the frame.
+const StagingOwner frameStagingOwner = 0;
+
+struct StagingAllocation {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    // Points at offset within the persistently mapped ring.
+    void* data = nullptr;
+};
+
+/*
+ * One large persistently mapped buffer that every upload is staged through. Regions are handed
+ * out in ring order to an owner and recycled once the graphics timeline shows that the owner's
+ * submission which read them has completed, so uploading never creates or destroys a buffer.
+ * Not thread safe.
+ */
+class StagingRing {
+public:
+    // The ring is reported to memoryBudget when there is one.
+    void create(VmaAllocator allocator, Timeline& timeline, MemoryBudget* memoryBudget,
+                VkDeviceSize capacity = 64 * 1024 * 1024);
+    void destroy(VmaAllocator allocator);
+
+    // A new owner for uploads submitted on their own, like an UploadBatch. It stays open until
+    // it is submitted, frameStagingOwner is always open.
+    StagingOwner beginOwner();
+
+    // Waits for earlier uploads to complete if the ring is full, size must fit in the ring.
+    // Throws if owner isn't open.
+    StagingAllocation allocate(StagingOwner owner, VkDeviceSize size,
+                               VkDeviceSize alignment = 16);
+    // Makes the host writes to an allocation visible to the device.
+    void flush(VmaAllocator allocator, const StagingAllocation& allocation);
+    // Gives back an allocation owner won't submit after all. Releasing the newest allocations
+    // first leaves the ring as it was before they were made.
+    void release(StagingOwner owner, const StagingAllocation& allocation);
+    // Gives back everything owner allocated and hasn't submitted, then closes it, for an owner
+    // that won't submit at all.
+    void releaseOwner(StagingOwner owner);
+    // What owner allocated and hasn't submitted yet is recycled once the timeline reaches
+    // timelineValue, call this with the value of the owner's submission that reads it. Closes
+    // owner, and throws if it wasn't open, so nothing else can claim an open owner's regions.
+    void submit(StagingOwner owner, uint64_t timelineValue);
+
+    // The most a single allocation can hold.
+    VkDeviceSize getCapacity() const;
+
+private:
+    enum class RegionState { Pending, Submitted, Released };
+
+    // Regions are kept in ring order, which is the order their space is freed in.
+    struct Region {
+        StagingOwner owner;
+        VkDeviceSize offset;
+        // Where head was before the region was allocated, to give back the newest region.
+        VkDeviceSize previousHead;
+        VkDeviceSize consumedBytes;
+        RegionState state;
+        uint64_t timelineValue;
+    };
+
+    void reclaim();
+    // Hands the space of released regions at the newest end of the ring straight back.
+    void popReleased();
+    bool isOpen(StagingOwner owner) const;
+    Region& getRegion(size_t index);
+    void pushRegion(const Region& region);
+
+    Timeline* timeline = nullptr;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    char* mappedData = nullptr;
+    VkDeviceSize capacity = 0;
+
+    // The free space always runs from head up to the oldest region still in use.
+    VkDeviceSize head = 0;
+    VkDeviceSize usedBytes = 0;
+    StagingOwner nextOwner = frameStagingOwner + 1;
+    std::vector<StagingOwner> openOwners;
+
+    // A circular queue that only grows, so staging doesn't allocate once it has.
+    std::vector<Region> regions;
+    size_t firstRegion = 0;
+    size_t regionCount = 0;
+};
\ No newline at end of file
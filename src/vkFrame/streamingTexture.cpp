@@ -0,0 +1,154 @@
+#include "streamingTexture.hpp"
+
+void StreamingTexture::create(const std::string& path, UploadBatch& batch, VkDevice device,
+                              const MipCache* mipCache, uint32_t initialSize) {
+    chain = Image::loadMipChain(path, true, 0, 0, 1, mipCache);
+
+    const std::vector<TextureLevel>& levels = chain.getLevels();
+    uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+    if (levels[0].byteSize >= batch.getStagingCapacity()) {
+        chain = MipChain();
+        throw std::runtime_error("Texture is too large to stream through the staging ring!");
+    }
+
+    // The smallest level is always uploaded, however small initialSize is.
+    residentLevel = levelCount - 1;
+    while (residentLevel > 0 &&
+           std::max(levels[residentLevel - 1].width, levels[residentLevel - 1].height) <=
+               initialSize) {
+        residentLevel--;
+    }
+    targetLevel = 0;
+
+    image = Image(batch.getAllocator(), chain.getWidth(), chain.getHeight(),
+                  VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
+                  VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, levelCount, 1, VK_SAMPLE_COUNT_1_BIT,
+                  batch.getMemoryBudget());
+
+    // The resident levels are the tail of the chain, so they are staged in one piece.
+    const TextureLevel& firstLevel = levels[residentLevel];
+    StagingAllocation staging = batch.stage(chain.getData().data() + firstLevel.offset,
+                                            chain.getData().size() - firstLevel.offset);
+
+    // Levels that haven't arrived go to the shader read layout too, the view never includes
+    // them and recordNextLevel discards whatever they hold.
+    VkCommandBuffer commandBuffer = batch.getCommandBuffer();
+    image.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    for (uint32_t i = residentLevel; i < levelCount; i++) {
+        image.copyLevelFromBuffer(commandBuffer, staging, i, levels[i].offset - firstLevel.offset);
+    }
+    image.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    view = image.createTextureView(device, residentLevel);
+
+    if (residentLevel == 0) {
+        chain = MipChain();
+    }
+}
+
+void StreamingTexture::destroy(VkDevice device, VmaAllocator allocator) {
+    if (view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, view, nullptr);
+        view = VK_NULL_HANDLE;
+    }
+
+    image.destroy(allocator);
+    chain = MipChain();
+}
+
+void StreamingTexture::setTargetLevel(uint32_t level) { targetLevel = level; }
+
+bool StreamingTexture::hasPendingLevel() const { return residentLevel > targetLevel; }
+
+VkDeviceSize StreamingTexture::getPendingLevelSize() const {
+    return chain.getLevels()[residentLevel - 1].byteSize;
+}
+
+void StreamingTexture::recordNextLevel(VkCommandBuffer commandBuffer, Commands& commands,
+                                       VmaAllocator allocator, VkDevice device,
+                                       DeletionQueue& deletionQueue) {
+    if (!hasPendingLevel())
+        return;
+
+    uint32_t level = residentLevel - 1;
+    const TextureLevel& textureLevel = chain.getLevels()[level];
+
+    StagingRing& stagingRing = commands.getStagingRing();
+    StagingAllocation staging = stagingRing.allocate(frameStagingOwner, textureLevel.byteSize);
+    memcpy(staging.data, chain.getData().data() + textureLevel.offset, textureLevel.byteSize);
+    stagingRing.flush(allocator, staging);
+
+    // Nothing has sampled the level yet, so its old contents are discarded.
+    image.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, level, 1);
+    image.copyLevelFromBuffer(commandBuffer, staging, level);
+    image.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level, 1);
+
+    // Frames in flight keep sampling through the old view.
+    deletionQueue.retireImageView(device, view);
+    view = image.createTextureView(device, level);
+    residentLevel = level;
+
+    if (residentLevel == 0) {
+        chain = MipChain();
+    }
+}
+
+VkImageView StreamingTexture::getView() const { return view; }
+
+uint32_t StreamingTexture::getResidentLevel() const { return residentLevel; }
+
+bool StreamingTexture::isFullyResident() const { return residentLevel == 0; }
+
+Image& StreamingTexture::getImage() { return image; }
+
+void TextureStreamer::setFrameBudget(VkDeviceSize byteSize) { frameBudget = byteSize; }
+
+void TextureStreamer::add(StreamingTexture& texture) {
+    if (!texture.isFullyResident()) {
+        textures.push_back(&texture);
+    }
+}
+
+void TextureStreamer::remove(StreamingTexture& texture) {
+    textures.erase(std::remove(textures.begin(), textures.end(), &texture), textures.end());
+}
+
+bool TextureStreamer::recordUpdates(VkCommandBuffer commandBuffer, Commands& commands,
+                                    VmaAllocator allocator, VkDevice device,
+                                    DeletionQueue& deletionQueue) {
+    VkDeviceSize budget = frameBudget;
+    bool recorded = false;
+    bool progressed = true;
+
+    while (progressed) {
+        progressed = false;
+
+        for (StreamingTexture* texture : textures) {
+            if (!texture->hasPendingLevel())
+                continue;
+
+            VkDeviceSize byteSize = texture->getPendingLevelSize();
+            if (recorded && byteSize > budget)
+                continue;
+
+            texture->recordNextLevel(commandBuffer, commands, allocator, device, deletionQueue);
+            budget -= std::min(byteSize, budget);
+            recorded = true;
+            progressed = true;
+        }
+    }
+
+    textures.erase(std::remove_if(textures.begin(), textures.end(),
+                                  [](StreamingTexture* texture) {
+                                      return texture->isFullyResident();
+                                  }),
+                   textures.end());
+
+    return recorded;
+}
\ No newline at end of file
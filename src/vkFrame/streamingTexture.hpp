@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "commands.hpp"
+#include "deletionQueue.hpp"
+#include "image.hpp"
+#include "mipChain.hpp"
+#include "uploadBatch.hpp"
+
+/*
+ * A texture whose mip levels become resident a few at a time, starting with the smallest. The
+ * view only covers the resident levels, clamping sampling to the most detailed one that has
+ * arrived, so the texture can be drawn from the first frame while the rest stream in.
+ */
+class StreamingTexture {
+public:
+    // Uploads the levels no larger than initialSize through batch, the others stay in memory
+    // until they are streamed. The whole chain is allocated up front, its levels are read from
+    // mipCache or saved there unless it is null. Each streamed level is staged in one piece next
+    // to the frame's other uploads, so this throws if the largest level isn't smaller than the
+    // staging ring, 4096 x 4096 and up with the default ring.
+    void create(const std::string& path, UploadBatch& batch, VkDevice device,
+                const MipCache* mipCache, uint32_t initialSize = 64);
+    void destroy(VkDevice device, VmaAllocator allocator);
+
+    // The most detailed level to stream in, raise it for textures that are far away or hidden.
+    // Levels that are already resident stay resident.
+    void setTargetLevel(uint32_t level);
+    // Whether recordNextLevel has a level to upload, and how many bytes it is.
+    bool hasPendingLevel() const;
+    VkDeviceSize getPendingLevelSize() const;
+    // Records the upload of the next more detailed level and replaces the view with one that
+    // includes it, retiring the old view. Call with the frame's command buffer outside a render
+    // pass, before anything samples the texture.
+    void recordNextLevel(VkCommandBuffer commandBuffer, Commands& commands,
+                         VmaAllocator allocator, VkDevice device, DeletionQueue& deletionQueue);
+
+    // Changes whenever a level arrives, write it to the frame's descriptor set again when
+    // getResidentLevel differs from the level it was written with.
+    VkImageView getView() const;
+    // The most detailed resident level, the minimum LOD the view clamps sampling to.
+    uint32_t getResidentLevel() const;
+    bool isFullyResident() const;
+    Image& getImage();
+
+private:
+    Image image;
+    VkImageView view = VK_NULL_HANDLE;
+    // Holds every level until the texture is fully resident.
+    MipChain chain;
+    uint32_t residentLevel = 0;
+    uint32_t targetLevel = 0;
+};
+
+/*
+ * Streams the levels of many textures under a per-frame upload budget. Every texture gets one
+ * level per round, so they all sharpen at the same pace instead of the first one taking the
+ * whole budget.
+ */
+class TextureStreamer {
+public:
+    // Bytes of texels uploaded per frame at most, a level larger than the budget is still
+    // uploaded when it is the frame's first.
+    void setFrameBudget(VkDeviceSize byteSize);
+    // The texture has to outlive the streamer or be removed first.
+    void add(StreamingTexture& texture);
+    void remove(StreamingTexture& texture);
+
+    // Call once per frame with the frame's command buffer, outside a render pass. Returns
+    // whether any view changed, textures that are fully resident are dropped.
+    bool recordUpdates(VkCommandBuffer commandBuffer, Commands& commands, VmaAllocator allocator,
+                       VkDevice device, DeletionQueue& deletionQueue);
+
+private:
+    VkDeviceSize frameBudget = 4 * 1024 * 1024;
+    std::vector<StreamingTexture*> textures;
+};
\ No newline at end of file
@@ -3,6 +3,19 @@
 void Swapchain::create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
                        int32_t windowWidth, int32_t windowHeight,
                        VkPresentModeKHR preferredPresentMode) {
+    this->preferredPresentMode = preferredPresentMode;
+
+    if (headless) {
+        createHeadless(device, windowWidth, windowHeight);
+        return;
+    }
+
+    createSwapchain(device, physicalDevice, surface, windowWidth, windowHeight, VK_NULL_HANDLE);
+}
+
+void Swapchain::createSwapchain(VkDevice device, VkPhysicalDevice physicalDevice,
+                                VkSurfaceKHR surface, int32_t windowWidth, int32_t windowHeight,
+                                VkSwapchainKHR oldSwapchain) {
     SwapchainSupportDetails swapchainSupport = querySupport(physicalDevice, surface);
 
     VkSurfaceFormatKHR surfaceFormat = chooseSurfaceFormat(swapchainSupport.formats);
@@ -10,30 +23,30 @@ void Swapchain::create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfa
         choosePresentMode(swapchainSupport.presentModes, preferredPresentMode);
     extent = chooseExtent(swapchainSupport.capabilities, windowWidth, windowHeight);
 
-    uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
+    uint32_t requestedImageCount = swapchainSupport.capabilities.minImageCount + 1;
     if (swapchainSupport.capabilities.maxImageCount > 0 &&
-        imageCount > swapchainSupport.capabilities.maxImageCount) {
-        imageCount = swapchainSupport.capabilities.maxImageCount;
+        requestedImageCount > swapchainSupport.capabilities.maxImageCount) {
+        requestedImageCount = swapchainSupport.capabilities.maxImageCount;
     }
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
     createInfo.surface = surface;
 
-    createInfo.minImageCount = imageCount;
+    createInfo.minImageCount = requestedImageCount;
     createInfo.imageFormat = surfaceFormat.format;
     createInfo.imageColorSpace = surfaceFormat.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
-    QueueFamilyIndices indices = QueueFamilyIndices::findQueueFamilies(physicalDevice, surface);
-    uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+    uint32_t sharingFamilies[] = {queueFamilyIndices.graphicsFamily.value(),
+                                  queueFamilyIndices.presentFamily.value()};
 
-    if (indices.graphicsFamily != indices.presentFamily) {
+    if (queueFamilyIndices.graphicsFamily != queueFamilyIndices.presentFamily) {
         createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
         createInfo.queueFamilyIndexCount = 2;
-        createInfo.pQueueFamilyIndices = queueFamilyIndices;
+        createInfo.pQueueFamilyIndices = sharingFamilies;
     } else {
         createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     }
@@ -42,11 +55,14 @@ void Swapchain::create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfa
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapchain;
 
     if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapchain) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create swap chain!");
     }
 
+    // The driver may create more images than requested.
+    vkGetSwapchainImagesKHR(device, swapchain, &imageCount, nullptr);
     imageFormat = surfaceFormat.format;
 }
 
@@ -116,26 +132,138 @@ VkExtent2D Swapchain::chooseExtent(const VkSurfaceCapabilitiesKHR& capabilities,
     }
 }
 
+void Swapchain::createHeadless(VkDevice device, int32_t windowWidth, int32_t windowHeight) {
+    extent = {static_cast<uint32_t>(windowWidth), static_cast<uint32_t>(windowHeight)};
+    imageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+
+    headlessImages.clear();
+    headlessImages.reserve(headlessImageCount);
+
+    for (uint32_t i = 0; i < headlessImageCount; i++) {
+        headlessImages.push_back(Image(headlessAllocator, extent.width, extent.height, imageFormat,
+                                       VK_IMAGE_TILING_OPTIMAL,
+                                       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                           VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, 1,
+                                       VK_SAMPLE_COUNT_1_BIT, headlessMemoryBudget));
+    }
+
+    nextHeadlessImage = 0;
+}
+
+void Swapchain::setHeadless(VmaAllocator allocator, uint32_t offscreenImageCount,
+                            MemoryBudget* memoryBudget) {
+    headless = true;
+    headlessAllocator = allocator;
+    headlessMemoryBudget = memoryBudget;
+    headlessImageCount = offscreenImageCount;
+}
+
+bool Swapchain::isHeadless() { return headless; }
+
+void Swapchain::setQueueFamilyIndices(const QueueFamilyIndices& queueFamilyIndices) {
+    this->queueFamilyIndices = queueFamilyIndices;
+}
+
 void Swapchain::cleanup(VmaAllocator allocator, VkDevice device) {
+    if (headless) {
+        for (Image& image : headlessImages) {
+            image.destroy(allocator);
+        }
+
+        headlessImages.clear();
+        return;
+    }
+
+    // The device is idle, so nothing is still presenting from the retired ones.
+    for (const RetiredSwapchain& retired : retiredSwapchains) {
+        vkDestroySwapchainKHR(device, retired.swapchain, nullptr);
+    }
+    retiredSwapchains.clear();
+
     vkDestroySwapchainKHR(device, swapchain, nullptr);
 }
 
 void Swapchain::recreate(VmaAllocator allocator, VkDevice device, VkPhysicalDevice physicalDevice,
-                         VkSurfaceKHR surface, int32_t windowWidth, int32_t windowHeight) {
-    vkDeviceWaitIdle(device);
+                         VkSurfaceKHR surface, int32_t windowWidth, int32_t windowHeight,
+                         DeletionQueue& deletionQueue) {
+    if (headless) {
+        for (Image& image : headlessImages) {
+            image.retire(allocator, deletionQueue);
+        }
+
+        createHeadless(device, windowWidth, windowHeight);
+        return;
+    }
 
-    cleanup(allocator, device);
+    // The presentation engine may still be reading the old swapchain's images after the frames
+    // that rendered them have completed, and without VK_EXT_swapchain_maintenance1 there is no
+    // fence telling when a present is done. Presents are processed in order, so the old swapchain
+    // is kept until a full ring of images, as many as the new swapchain has, has been presented
+    // after it. Then it is retired until the frames from before the resize have completed.
+    VkSwapchainKHR oldSwapchain = swapchain;
+    createSwapchain(device, physicalDevice, surface, windowWidth, windowHeight, oldSwapchain);
 
-    create(device, physicalDevice, surface, windowWidth, windowHeight);
+    retiredSwapchains.push_back(RetiredSwapchain{oldSwapchain, imageCount});
+}
+
+void Swapchain::presented(VkDevice device, DeletionQueue& deletionQueue) {
+    for (RetiredSwapchain& retired : retiredSwapchains) {
+        retired.presentsLeft--;
+
+        if (retired.presentsLeft == 0) {
+            // Frames from before the resize may still be rendering into its images.
+            deletionQueue.push([device, oldSwapchain = retired.swapchain] {
+                vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+            });
+        }
+    }
+
+    retiredSwapchains.erase(std::remove_if(retiredSwapchains.begin(), retiredSwapchains.end(),
+                                           [](const RetiredSwapchain& retired) {
+                                               return retired.presentsLeft == 0;
+                                           }),
+                            retiredSwapchains.end());
 }
 
 VkResult Swapchain::getNextImage(VkDevice device, VkSemaphore semaphore, uint32_t& imageIndex) {
+    if (headless) {
+        imageIndex = nextHeadlessImage;
+        nextHeadlessImage = (nextHeadlessImage + 1) % headlessImageCount;
+        return VK_SUCCESS;
+    }
+
     return vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, semaphore, VK_NULL_HANDLE,
                                  &imageIndex);
 }
 
+void Swapchain::getImages(VkDevice device, std::vector<Image>& images) {
+    images.clear();
+
+    if (headless) {
+        images = headlessImages;
+        return;
+    }
+
+    uint32_t swapchainImageCount;
+    vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, nullptr);
+    std::vector<VkImage> imagesVk(swapchainImageCount);
+    vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, imagesVk.data());
+
+    images.reserve(swapchainImageCount);
+
+    for (VkImage vkImage : imagesVk) {
+        images.push_back(Image(vkImage, imageFormat));
+    }
+}
+
 const VkSwapchainKHR& Swapchain::getSwapchain() { return swapchain; }
 
 const VkFormat& Swapchain::getImageFormat() { return imageFormat; }
 
-const VkExtent2D& Swapchain::getExtent() { return extent; }
\ No newline at end of file
+const VkExtent2D& Swapchain::getExtent() { return extent; }
+
+VkImageLayout Swapchain::getPresentLayout() {
+    // Offscreen images are never presented, leave them ready to be copied out instead.
+    return headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
\ No newline at end of file
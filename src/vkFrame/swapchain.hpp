@@ -3,11 +3,13 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
 #include <array>
 #include <limits>
 #include <stdexcept>
 #include <vector>
 
+#include "deletionQueue.hpp"
 #include "image.hpp"
 #include "queueFamilyIndices.hpp"
 
@@ -23,8 +25,22 @@ public:
                 int32_t windowWidth, int32_t windowHeight,
                 VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR);
     void cleanup(VmaAllocator allocator, VkDevice device);
+    // Hands the old swapchain to the new one without waiting, so frames still in flight keep
+    // running. The old one is destroyed once presented has counted a full ring of presents from
+    // the new one and the frames rendered before the resize have completed.
     void recreate(VmaAllocator allocator, VkDevice device, VkPhysicalDevice physicalDevice,
-                  VkSurfaceKHR surface, int32_t windowWidth, int32_t windowHeight);
+                  VkSurfaceKHR surface, int32_t windowWidth, int32_t windowHeight,
+                  DeletionQueue& deletionQueue);
+    // Call after every image queued for presentation, to retire old swapchains.
+    void presented(VkDevice device, DeletionQueue& deletionQueue);
+
+    // When headless, create() makes a ring of offscreen images instead of a real swapchain. They
+    // are reported to memoryBudget when there is one.
+    void setHeadless(VmaAllocator allocator, uint32_t offscreenImageCount,
+                     MemoryBudget* memoryBudget = nullptr);
+    // Decides whether images are shared between the graphics and present families.
+    void setQueueFamilyIndices(const QueueFamilyIndices& queueFamilyIndices);
+    bool isHeadless();
 
     SwapchainSupportDetails querySupport(VkPhysicalDevice device, VkSurfaceKHR surface);
     VkSurfaceFormatKHR chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -33,13 +49,36 @@ public:
     VkExtent2D chooseExtent(const VkSurfaceCapabilitiesKHR& capabilities, int32_t windowWidth,
                             int32_t windowHeight);
     VkResult getNextImage(VkDevice device, VkSemaphore semaphore, uint32_t& imageIndex);
+    void getImages(VkDevice device, std::vector<Image>& images);
 
     const VkSwapchainKHR& getSwapchain();
     const VkExtent2D& getExtent();
     const VkFormat& getImageFormat();
+    VkImageLayout getPresentLayout();
 
 private:
-    VkSwapchainKHR swapchain;
+    // A swapchain replaced by recreate that presents queued before the resize may still be using.
+    struct RetiredSwapchain {
+        VkSwapchainKHR swapchain;
+        uint32_t presentsLeft;
+    };
+
+    void createSwapchain(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+                         int32_t windowWidth, int32_t windowHeight, VkSwapchainKHR oldSwapchain);
+    void createHeadless(VkDevice device, int32_t windowWidth, int32_t windowHeight);
+
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    uint32_t imageCount = 0;
+    std::vector<RetiredSwapchain> retiredSwapchains;
+    VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
     VkExtent2D extent;
     VkFormat imageFormat;
+    QueueFamilyIndices queueFamilyIndices;
+
+    bool headless = false;
+    VmaAllocator headlessAllocator;
+    MemoryBudget* headlessMemoryBudget = nullptr;
+    std::vector<Image> headlessImages;
+    uint32_t headlessImageCount = 0;
+    uint32_t nextHeadlessImage = 0;
 };
\ No newline at end of file
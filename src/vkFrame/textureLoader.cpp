@@ -0,0 +1,115 @@
+#include "textureLoader.hpp"
+
+size_t TextureLoader::add(const std::string& path, bool enableMipmaps) {
+    Request request;
+    request.path = path;
+    request.enableMipmaps = enableMipmaps;
+    requests.push_back(request);
+
+    return requests.size() - 1;
+}
+
+size_t TextureLoader::addArray(const std::string& path, bool enableMipmaps, uint32_t width,
+                               uint32_t height, uint32_t layers) {
+    Request request;
+    request.path = path;
+    request.enableMipmaps = enableMipmaps;
+    request.width = width;
+    request.height = height;
+    request.layers = layers;
+    requests.push_back(request);
+
+    return requests.size() - 1;
+}
+
+std::vector<Image> TextureLoader::load(UploadBatch& batch, WorkerPool& workerPool,
+                                       const MipCache* mipCache) {
+    uint32_t requestCount = static_cast<uint32_t>(requests.size());
+
+    // Only the headers are read here, to know how much staging memory each file needs.
+    auto readInfo = [&](uint32_t taskIndex, uint32_t workerIndex) {
+        Request& request = requests[taskIndex];
+        int32_t channels;
+        if (!stbi_info(request.path.c_str(), &request.texWidth, &request.texHeight, &channels)) {
+            throw std::runtime_error("Failed to load texture image!");
+        }
+    };
+    workerPool.parallelFor(requestCount, readInfo);
+
+    // The first level is cut straight into the staging ring, the others are generated from the
+    // decoded texels rather than read back from the ring, which is write combined memory.
+    auto decode = [&](uint32_t taskIndex, uint32_t workerIndex) {
+        Request& request = requests[taskIndex];
+        int32_t width, height, channels;
+        stbi_uc* pixels =
+            stbi_load(request.path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+        if (!pixels) {
+            throw std::runtime_error("Failed to load texture image!");
+        }
+
+        if (width != request.texWidth || height != request.texHeight) {
+            stbi_image_free(pixels);
+            throw std::runtime_error("Texture image changed while it was being loaded!");
+        }
+
+        try {
+            MipChain::buildInto(pixels, width, height, request.width, request.height,
+                                request.layers, static_cast<uint32_t>(request.levels.size()), true,
+                                static_cast<uint8_t*>(request.levelData.data), mipCache);
+            stbi_image_free(pixels);
+        } catch (...) {
+            stbi_image_free(pixels);
+            throw;
+        }
+    };
+
+    // Nothing is recorded into the batch until every file has decoded, and a file that fails to
+    // load gives back the staging handed out for every file.
+    try {
+        // The staging ring isn't thread safe, so every region is handed out before decoding.
+        for (Request& request : requests) {
+            if (request.width == 0) {
+                request.width = request.texWidth;
+                request.height = request.texHeight;
+            }
+
+            uint32_t levelCount =
+                request.enableMipmaps ? Image::calcMipmapLevels(request.width, request.height) : 1;
+            request.levels =
+                MipChain::layout(request.width, request.height, request.layers, levelCount);
+
+            const TextureLevel& lastLevel = request.levels.back();
+            request.levelData = batch.allocate(lastLevel.offset + lastLevel.byteSize);
+        }
+
+        workerPool.parallelFor(requestCount, decode);
+    } catch (...) {
+        releaseStaging(batch);
+        throw;
+    }
+
+    std::vector<Image> textures;
+    textures.reserve(requests.size());
+
+    for (const Request& request : requests) {
+        batch.flush(request.levelData);
+
+        textures.push_back(Image::createTextureFromLevels(
+            batch, request.levelData, VK_FORMAT_R8G8B8A8_SRGB, request.width, request.height,
+            request.layers, request.levels));
+    }
+
+    requests.clear();
+
+    return textures;
+}
+
+void TextureLoader::releaseStaging(UploadBatch& batch) {
+    for (auto request = requests.rbegin(); request != requests.rend(); ++request) {
+        if (request->levelData.data != nullptr) {
+            batch.release(request->levelData);
+            request->levelData = StagingAllocation{};
+        }
+    }
+}
\ No newline at end of file
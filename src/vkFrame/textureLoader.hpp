@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "image.hpp"
+#include "uploadBatch.hpp"
+#include "workerPool.hpp"
+
+/*
+ * Loads many textures at once. Every file is decoded and has its mip levels built on its own
+ * WorkerPool task, straight into the region of the staging ring its texture is uploaded from.
+ * Every upload is recorded into one UploadBatch, so loading scales with the number of cores
+ * instead of running file by file.
+ */
+class TextureLoader {
+public:
+    // Returns the index of the texture in what load returns.
+    size_t add(const std::string& path, bool enableMipmaps);
+    // Splits the file into layers of width * height texels, like Image::createTextureArray.
+    size_t addArray(const std::string& path, bool enableMipmaps, uint32_t width, uint32_t height,
+                    uint32_t layers);
+
+    // Decodes every added file and records its upload into batch, then forgets the files. The
+    // textures can't be used until the batch has been submitted, and all of them have to fit in
+    // the staging ring at the same time. If a file fails to load the batch is left as it was and
+    // the files are kept. Mip levels are read from mipCache, or saved there, when there is one.
+    std::vector<Image> load(UploadBatch& batch, WorkerPool& workerPool,
+                            const MipCache* mipCache = nullptr);
+
+private:
+    struct Request {
+        std::string path;
+        bool enableMipmaps = false;
+        // Zero for a plain texture, until load fills in the size of the image.
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t layers = 1;
+
+        int32_t texWidth = 0;
+        int32_t texHeight = 0;
+        std::vector<TextureLevel> levels;
+        StagingAllocation levelData;
+    };
+
+    // Gives every region handed out so far back to batch, newest first.
+    void releaseStaging(UploadBatch& batch);
+
+    std::vector<Request> requests;
+};
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "timeline.hpp"
+
+void Timeline::create(VkDevice device) {
+    this->device = device;
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timeline semaphore!");
+    }
+
+    reservedValue = 0;
+    lastSubmittedValue = 0;
+    completedValue = 0;
+}
+
+void Timeline::destroy(VkDevice device) {
+    vkDestroySemaphore(device, semaphore, nullptr);
+    semaphore = VK_NULL_HANDLE;
+}
+
+uint64_t Timeline::reserveValue() {
+    if (reservedValue == lastSubmittedValue) {
+        reservedValue++;
+    }
+
+    return reservedValue;
+}
+
+uint64_t Timeline::getReservedValue() { return reservedValue; }
+
+uint64_t Timeline::nextValue() {
+    lastSubmittedValue = reserveValue();
+    return lastSubmittedValue;
+}
+
+uint64_t Timeline::getLastSubmittedValue() { return lastSubmittedValue; }
+
+uint64_t Timeline::getCompletedValue() {
+    if (completedValue < lastSubmittedValue) {
+        if (vkGetSemaphoreCounterValue(device, semaphore, &completedValue) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to read timeline semaphore!");
+        }
+    }
+
+    return completedValue;
+}
+
+bool Timeline::isComplete(uint64_t value) {
+    // Checking the cached value first avoids a driver call for work known to be done.
+    return value <= completedValue || value <= getCompletedValue();
+}
+
+void Timeline::wait(uint64_t value) {
+    if (isComplete(value))
+        return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+
+    if (vkWaitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to wait for timeline semaphore!");
+    }
+
+    completedValue = std::max(completedValue, value);
+}
+
+const VkSemaphore& Timeline::getSemaphore() { return semaphore; }
\ No newline at end of file
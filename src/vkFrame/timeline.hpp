@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+/*
+ * A timeline semaphore counting work submitted to the graphics queue. Every submission signals
+ * the next value, so "the GPU has completed value N" orders frames, uploads and deletions alike.
+ * The renderer keeps a second one that only its frames signal, to know a frame's value while it
+ * is still being recorded.
+ */
+class Timeline {
+public:
+    void create(VkDevice device);
+    void destroy(VkDevice device);
+
+    // Reserves the value the next submission will signal, reserving again before that submission
+    // returns the same value.
+    uint64_t reserveValue();
+    // The value reserved last, or the last submitted one if it hasn't been reserved since.
+    uint64_t getReservedValue();
+    // Takes the reserved value for a submission, or reserves one if there isn't any.
+    uint64_t nextValue();
+    uint64_t getLastSubmittedValue();
+
+    // The latest value the GPU has signalled, this never blocks.
+    uint64_t getCompletedValue();
+    bool isComplete(uint64_t value);
+    // Blocks until the GPU has signalled value, returns immediately if it already has.
+    void wait(uint64_t value);
+
+    const VkSemaphore& getSemaphore();
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    uint64_t reservedValue = 0;
+    uint64_t lastSubmittedValue = 0;
+    uint64_t completedValue = 0;
+};
\ No newline at end of file
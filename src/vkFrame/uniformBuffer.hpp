@@ -7,24 +7,23 @@
 
 template <typename T> class UniformBuffer {
 public:
-    void create(const uint32_t maxFramesInFlight, VmaAllocator allocator) {
+    void create(const uint32_t maxFramesInFlight, VmaAllocator allocator,
+                MemoryBudget* memoryBudget = nullptr) {
         VkDeviceSize bufferByteSize = sizeof(T);
 
         buffers.resize(maxFramesInFlight);
         buffersMapped.resize(maxFramesInFlight);
 
         for (size_t i = 0; i < maxFramesInFlight; i++) {
-            buffers[i] =
-                Buffer(allocator, bufferByteSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, true);
+            buffers[i] = Buffer(allocator, bufferByteSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, true,
+                                memoryBudget);
             buffers[i].map(allocator, &buffersMapped[i]);
         }
     }
 
-    void update(const T& data) {
-        size_t bufferCount = buffersMapped.size();
-        for (size_t i = 0; i < bufferCount; i++) {
-            memcpy(buffersMapped[i], &data, sizeof(T));
-        }
+    // Only writes the current frame's copy, the other frames in flight may still be reading theirs.
+    void update(const T& data, const uint32_t currentFrame) {
+        memcpy(buffersMapped[currentFrame], &data, sizeof(T));
     }
 
     const VkBuffer& getBuffer(uint32_t i) { return buffers[i].getBuffer(); }
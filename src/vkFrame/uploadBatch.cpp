@@ -0,0 +1,99 @@
+#include "uploadBatch.hpp"
+
+UploadBatch::~UploadBatch() {
+    if (commandBuffer != VK_NULL_HANDLE) {
+        abort();
+    }
+}
+
+void UploadBatch::begin(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue,
+                        VkDevice device, MemoryBudget* memoryBudget) {
+    if (commandBuffer != VK_NULL_HANDLE) {
+        throw std::runtime_error("Upload batch was begun again before being submitted!");
+    }
+
+    this->allocator = allocator;
+    this->memoryBudget = memoryBudget;
+    this->commands = &commands;
+    this->graphicsQueue = graphicsQueue;
+    this->device = device;
+    timelineValue = 0;
+    stagingOwner = commands.getStagingRing().beginOwner();
+
+    commandBuffer = commands.beginSingleTime(graphicsQueue, device);
+}
+
+StagingAllocation UploadBatch::stage(const void* data, VkDeviceSize byteSize) {
+    StagingAllocation staging = allocate(byteSize);
+    memcpy(staging.data, data, byteSize);
+    flush(staging);
+
+    return staging;
+}
+
+StagingAllocation UploadBatch::allocate(VkDeviceSize byteSize) {
+    if (commandBuffer == VK_NULL_HANDLE) {
+        throw std::runtime_error("Upload batch staged an upload without being begun!");
+    }
+
+    return commands->getStagingRing().allocate(stagingOwner, byteSize);
+}
+
+void UploadBatch::flush(const StagingAllocation& staging) {
+    commands->getStagingRing().flush(allocator, staging);
+}
+
+void UploadBatch::release(const StagingAllocation& staging) {
+    commands->getStagingRing().release(stagingOwner, staging);
+}
+
+const VkCommandBuffer& UploadBatch::getCommandBuffer() { return commandBuffer; }
+
+VmaAllocator UploadBatch::getAllocator() { return allocator; }
+
+MemoryBudget* UploadBatch::getMemoryBudget() { return memoryBudget; }
+
+VkDeviceSize UploadBatch::getStagingCapacity() { return commands->getStagingRing().getCapacity(); }
+
+uint64_t UploadBatch::submit() {
+    if (commandBuffer == VK_NULL_HANDLE) {
+        throw std::runtime_error("Upload batch was submitted without being begun!");
+    }
+
+    // Vertex, index and instance buffers have no barrier of their own after being copied to.
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0,
+                         nullptr);
+
+    timelineValue = commands->submitSingleTime(commandBuffer, graphicsQueue);
+    commands->getStagingRing().submit(stagingOwner, timelineValue);
+    commandBuffer = VK_NULL_HANDLE;
+
+    return timelineValue;
+}
+
+void UploadBatch::abort() {
+    if (commandBuffer == VK_NULL_HANDLE)
+        return;
+
+    commands->getStagingRing().releaseOwner(stagingOwner);
+    commands->freeSingleTime(commandBuffer, device);
+    commandBuffer = VK_NULL_HANDLE;
+}
+
+bool UploadBatch::isComplete() {
+    return timelineValue != 0 && commands->getTimeline().isComplete(timelineValue);
+}
+
+void UploadBatch::wait() {
+    if (timelineValue == 0) {
+        throw std::runtime_error("Upload batch was waited on without being submitted!");
+    }
+
+    commands->getTimeline().wait(timelineValue);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "commands.hpp"
+
+/*
+ * Records many uploads, layout transitions and mipmap generations into one command buffer and
+ * submits them together, so loading a batch of assets costs a single submission instead of a
+ * queue round trip per step. Submitting doesn't wait, the batch reports when the GPU is done.
+ */
+class UploadBatch {
+public:
+    // A batch that was begun and never submitted is aborted.
+    ~UploadBatch();
+
+    // Whatever the batch creates is reported to memoryBudget when there is one.
+    void begin(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device,
+               MemoryBudget* memoryBudget = nullptr);
+
+    // Copies data into the staging ring, the region is read once the batch has been submitted.
+    // The batch owns everything it stages until then, the ring only recycles it after the
+    // batch's own submission, so everything staged by one batch has to fit in the ring at once.
+    StagingAllocation stage(const void* data, VkDeviceSize byteSize);
+    // Reserves a region of the staging ring for the caller to fill, then call flush.
+    StagingAllocation allocate(VkDeviceSize byteSize);
+    void flush(const StagingAllocation& staging);
+    // Gives back a region nothing recorded into the batch reads after all.
+    void release(const StagingAllocation& staging);
+
+    const VkCommandBuffer& getCommandBuffer();
+    VmaAllocator getAllocator();
+    MemoryBudget* getMemoryBudget();
+    // The most a single stage or allocate can hold.
+    VkDeviceSize getStagingCapacity();
+
+    // Makes every copy visible to later submissions and returns the timeline value that signals
+    // completion, this never blocks.
+    uint64_t submit();
+    // Gives back everything staged and frees the command buffer without submitting it, nothing
+    // recorded into the batch runs. The batch can be begun again afterwards.
+    void abort();
+    bool isComplete();
+    // Blocks until the GPU has finished the batch.
+    void wait();
+
+private:
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    MemoryBudget* memoryBudget = nullptr;
+    Commands* commands = nullptr;
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    // Open in the staging ring from begin until submit.
+    StagingOwner stagingOwner = frameStagingOwner;
+    uint64_t timelineValue = 0;
+};
\ No newline at end of file
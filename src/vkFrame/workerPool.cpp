@@ -0,0 +1,149 @@
+#include "workerPool.hpp"
+
+void WorkerPool::create(uint32_t threadCount) {
+    stopping = false;
+    threads.reserve(threadCount);
+
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+    }
+}
+
+void WorkerPool::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    workAvailable.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    threads.clear();
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+    if (threads.empty()) {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        backgroundTasks.push_back(std::move(task));
+    }
+
+    workAvailable.notify_one();
+}
+
+uint32_t WorkerPool::getWorkerCount() { return static_cast<uint32_t>(threads.size()) + 1; }
+
+void WorkerPool::run(uint32_t taskCount, TaskFunction function, void* context) {
+    if (taskCount == 0)
+        return;
+
+    uint64_t runGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->function = function;
+        this->context = context;
+        this->taskCount = taskCount;
+        exception = nullptr;
+        generation++;
+        runGeneration = generation;
+        nextTask = (runGeneration & 0xFFFFFFFFull) << 32;
+        runActive = true;
+        activeWorkers++;
+    }
+
+    workAvailable.notify_all();
+
+    runTasks(0, runGeneration, function, context, taskCount);
+
+    // Every claimed task has finished once no worker is left inside runTasks. Workers that wake
+    // up after this see the run is over and don't join it.
+    std::unique_lock<std::mutex> lock(mutex);
+    activeWorkers--;
+    workFinished.wait(lock, [&] { return activeWorkers == 0; });
+
+    runActive = false;
+    this->function = nullptr;
+    this->context = nullptr;
+
+    if (exception) {
+        std::exception_ptr taskException = exception;
+        exception = nullptr;
+        std::rethrow_exception(taskException);
+    }
+}
+
+void WorkerPool::runTasks(uint32_t workerIndex, uint64_t runGeneration, TaskFunction runFunction,
+                          void* runContext, uint32_t runTaskCount) {
+    uint64_t runTag = runGeneration & 0xFFFFFFFFull;
+
+    while (true) {
+        // Claims only advance the counter while it still belongs to this run.
+        uint64_t claim = nextTask.load();
+        do {
+            if ((claim >> 32) != runTag || static_cast<uint32_t>(claim) >= runTaskCount)
+                return;
+        } while (!nextTask.compare_exchange_weak(claim, claim + 1));
+
+        uint32_t taskIndex = static_cast<uint32_t>(claim);
+
+        try {
+            runFunction(runContext, taskIndex, workerIndex);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+    }
+}
+
+void WorkerPool::workerLoop(uint32_t workerIndex) {
+    uint64_t seenGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [&] {
+            return stopping || (runActive && generation != seenGeneration) ||
+                   !backgroundTasks.empty();
+        });
+
+        // parallelFor work is waited on by the caller, so it always goes before background tasks.
+        if (!runActive || generation == seenGeneration || stopping) {
+            // Queued tasks still run when stopping, anything waiting on them would never return.
+            if (backgroundTasks.empty())
+                return;
+
+            std::function<void()> task = std::move(backgroundTasks.front());
+            backgroundTasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+            continue;
+        }
+
+        // The run's state is copied while holding the lock, the next run may replace it as soon
+        // as this one returns.
+        seenGeneration = generation;
+        TaskFunction runFunction = function;
+        void* runContext = context;
+        uint32_t runTaskCount = taskCount;
+        activeWorkers++;
+
+        lock.unlock();
+        runTasks(workerIndex, seenGeneration, runFunction, runContext, runTaskCount);
+        lock.lock();
+
+        activeWorkers--;
+        if (activeWorkers == 0) {
+            workFinished.notify_all();
+        }
+    }
+}
\ No newline at end of file
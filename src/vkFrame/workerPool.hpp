@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    // Starts threadCount worker threads, the thread calling parallelFor also runs tasks.
+    void create(uint32_t threadCount);
+    void destroy();
+
+    // Worker indices range from 0 (the calling thread) to getWorkerCount() - 1.
+    uint32_t getWorkerCount();
+
+    // Runs task(taskIndex, workerIndex) for every task index in [0, taskCount) and returns once
+    // all of them have finished. The first exception thrown by a task is rethrown here.
+    template <typename F> void parallelFor(uint32_t taskCount, F& task) {
+        run(taskCount, &invoke<F>, &task);
+    }
+
+    // Queues task to run on a worker thread once it has no parallelFor work, and returns
+    // straight away. The task must not throw. Without worker threads it runs before returning.
+    void submit(std::function<void()> task);
+
+private:
+    using TaskFunction = void (*)(void* context, uint32_t taskIndex, uint32_t workerIndex);
+
+    // Calling through a plain function pointer avoids the allocation a std::function may need.
+    template <typename F>
+    static void invoke(void* context, uint32_t taskIndex, uint32_t workerIndex) {
+        (*static_cast<F*>(context))(taskIndex, workerIndex);
+    }
+
+    void run(uint32_t taskCount, TaskFunction function, void* context);
+    // Works on the run of the given generation with the copies of its state taken when joining.
+    void runTasks(uint32_t workerIndex, uint64_t runGeneration, TaskFunction runFunction,
+                  void* runContext, uint32_t runTaskCount);
+    void workerLoop(uint32_t workerIndex);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workFinished;
+    bool stopping = false;
+
+    uint64_t generation = 0;
+    // Workers only join while the run of the current generation hasn't returned.
+    bool runActive = false;
+    uint32_t activeWorkers = 0;
+    TaskFunction function = nullptr;
+    void* context = nullptr;
+    uint32_t taskCount = 0;
+    // The low 32 bits of the generation above the next task index, so a claim made against an
+    // earlier run can never land inside a later run's range.
+    std::atomic<uint64_t> nextTask{0};
+    std::exception_ptr exception;
+
+    std::deque<std::function<void()>> backgroundTasks;
+};
\ No newline at end of file